@@ -0,0 +1,18 @@
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.h"
+
+std::atomic<size_t> number_of_allocations = 0;
+
+void* operator new(size_t size) {
+    number_of_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
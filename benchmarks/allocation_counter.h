@@ -0,0 +1,11 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief number_of_allocations every heap allocation of the program, counted by the replaced operator new
+ *
+ * The operators are defined in their own translation unit, so they aren't inlined into the code which is measured.
+ */
+extern std::atomic<size_t> number_of_allocations;
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "allocation_counter.h"
+#include "confusepp.h"
+
+using namespace confusepp;
+
+namespace {
+
+    using benchmark_clock = std::chrono::steady_clock;
+
+    template<typename F>
+    /**
+     * @brief milliseconds wall time of one call of the function
+     */
+    double milliseconds(F&& function) {
+        auto start = benchmark_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(benchmark_clock::now() - start).count();
+    }
+
+    /**
+     * @brief titled_sections config with one titled person section for every number
+     */
+    std::string titled_sections(size_t number_of_sections) {
+        std::string content;
+        content.reserve(number_of_sections * 48);
+
+        for (size_t i = 0; i < number_of_sections; ++i) {
+            content += "person p" + std::to_string(i) + " { age = " + std::to_string(i % 100) + " firstname = \"name" +
+                       std::to_string(i) + "\" }\n";
+        }
+
+        return content;
+    }
+
+    /**
+     * @brief The LoadedSection class, exposes the load of a section, so it can be timed without the parse of confuse
+     */
+    class LoadedSection final : public Section {
+       public:
+        explicit LoadedSection(const Section& section) : Section(section) {}
+
+        using Section::load_values;
+    };
+
+    /**
+     * @brief benchmark_titles loading has to grow linearly with the number of titled sections
+     *
+     * libconfuse itself searches all earlier titles for every titled section it parses (cfg_setopt), so its parse
+     * is quadratic and only done up to 100k sections. The load of the parsed handle into the tree is timed on its
+     * own. The native parser builds the same Multisection with the same title index without libconfuse, it is timed
+     * up to the limit.
+     */
+    void benchmark_titles(size_t limit) {
+        constexpr size_t confuse_limit = 100000;
+        ConfigFormat root{Multisection("person").values(Option<int>("age"), Option<std::string>("firstname"))};
+        auto schema = CompiledSchema::compile(root);
+        ParseOptions native_options;
+        native_options.native_parser = true;
+
+        std::printf("titled sections   confuse parse ms   load ms   load us/section   native ms   native us/section\n");
+
+        for (size_t number_of_sections = 1000; number_of_sections <= limit; number_of_sections *= 10) {
+            std::string content = titled_sections(number_of_sections);
+            double native = milliseconds([&] { Config::parse_buffer(content, schema, native_options); });
+
+            if (number_of_sections > confuse_limit) {
+                std::printf("%15zu   %16s   %7s   %15s   %9.1f   %17.3f\n", number_of_sections, "-", "-", "-", native,
+                            native * 1000 / number_of_sections);
+                std::fflush(stdout);
+                continue;
+            }
+
+            cfg_t* handle = nullptr;
+            double confuse_parse = milliseconds([&] { handle = parse_config_buffer(content, schema->options()); });
+            LoadedSection loaded(schema->prototype());
+            double load = milliseconds([&] { loaded.load_values(handle); });
+            cfg_free(handle);
+
+            std::printf("%15zu   %16.1f   %7.1f   %15.3f   %9.1f   %17.3f\n", number_of_sections, confuse_parse, load,
+                        load * 1000 / number_of_sections, native, native * 1000 / number_of_sections);
+            std::fflush(stdout);
+        }
+    }
+
+    /**
+     * @brief benchmark_lookups allocations and time of one lookup, a copy with get against find and bind
+     */
+    void benchmark_lookups(size_t number_of_lookups) {
+        ConfigFormat root{Option<int>("repeat"),
+                          Multisection("person").values(Option<int>("age"), Option<std::string>("firstname"))};
+        ParseOptions native_options;
+        native_options.native_parser = true;
+        auto config = Config::parse_buffer("repeat = 3\n" + titled_sections(1000), root, native_options);
+        auto bound_age = config->bind<Option<int>>("person/p500/age");
+        volatile long sink = 0;
+
+        auto measure = [number_of_lookups, &sink](const char* lookup_name, auto lookup) {
+            size_t allocations_before = number_of_allocations;
+            long checksum = 0;
+            double elapsed = milliseconds([&] {
+                for (size_t i = 0; i < number_of_lookups; ++i) {
+                    checksum += lookup();
+                }
+            });
+            double allocations = double(number_of_allocations - allocations_before) / number_of_lookups;
+
+            sink = checksum;
+            std::printf("%-44s   %18.2f   %9.1f\n", lookup_name, allocations, elapsed * 1e6 / number_of_lookups);
+            std::fflush(stdout);
+        };
+
+        std::printf("lookup in 1000 titled sections                 allocations/lookup   ns/lookup\n");
+        measure("get<Section>(path(\"person/p500\"))->age", [&config] {
+            return config->get<Section>(path("person/p500"))->find<Option<int>>("age")->value();
+        });
+        measure("get<Option<int>>(path(\"person/p500/age\"))",
+                [&config] { return config->get<Option<int>>(path("person/p500/age"))->value(); });
+        measure("get<Option<int>>(\"person/p500/age\")",
+                [&config] { return config->get<Option<int>>("person/p500/age")->value(); });
+        measure("find<Section>(\"person/p500\")->age",
+                [&config] { return config->find<Section>("person/p500")->find<Option<int>>("age")->value(); });
+        measure("find<Option<int>>(\"person/p500/age\")",
+                [&config] { return config->find<Option<int>>("person/p500/age")->value(); });
+        measure("bind<Option<int>>(\"person/p500/age\") once", [&bound_age] { return bound_age->value(); });
+    }
+
+    /**
+     * @brief benchmark_schema time of one parse of a small config with a ConfigFormat against a CompiledSchema
+     */
+    void benchmark_schema(size_t number_of_parses) {
+        ConfigFormat root{
+            Option<int>("repeat").default_value(1), Option<std::string>("target").default_value("World"),
+            Option<List<int>>("lotto_numbers").default_value(4, 8, 15, 16, 23, 42),
+            Option<List<std::string>>("presidents"),
+            Section("capital_of_states_in_germany")
+                .values(Option<std::string>("Baden-Wuerttemberg"), Option<std::string>("Bavaria"),
+                        Option<std::string>("Berlin"), Option<std::string>("Brandenburg"),
+                        Option<std::string>("Bremen"), Option<std::string>("Hamburg"), Option<std::string>("Hesse"),
+                        Option<std::string>("Lower Saxony"), Option<std::string>("Mecklenburg-Vorpommern"),
+                        Option<std::string>("North Rhine-Westphalia"), Option<std::string>("Rhineland-Palatinate"),
+                        Option<std::string>("Saarland"), Option<std::string>("Saxony"),
+                        Option<std::string>("Saxony-Anhalt"), Option<std::string>("Schleswig-Holstein"),
+                        Option<std::string>("Thuringia")),
+            Multisection("person").values(Option<std::string>("firstname"), Option<std::string>("lastname"),
+                                          Option<bool>("male"), Option<int>("age"),
+                                          Option<float>("constant").default_value(1.f))};
+        std::string content = "repeat = 3\ntarget = \"Neighbour\"\npresidents = {\"Heuss\", \"Luebke\"}\n"
+                              "capital_of_states_in_germany { Bavaria = \"Munich\" Saxony = \"Dresden\" }\n"
+                              "person turing { firstname = \"Alan\" lastname = \"Turing\" male = true age = 41 }\n"
+                              "person euler { firstname = \"Leonhard\" age = 76 constant = 2.71828 }\n";
+        auto schema = CompiledSchema::compile(root);
+        ParseOptions native_options;
+        native_options.native_parser = true;
+
+        auto measure = [number_of_parses](auto parse, double& microseconds, double& allocations) {
+            size_t allocations_before = number_of_allocations;
+            double elapsed = milliseconds([&] {
+                for (size_t i = 0; i < number_of_parses; ++i) {
+                    parse();
+                }
+            });
+            allocations = double(number_of_allocations - allocations_before) / number_of_parses;
+            microseconds = elapsed * 1000 / number_of_parses;
+        };
+
+        std::printf("parser      format us/parse   schema us/parse   saved us/parse   format allocs   schema allocs\n");
+
+        for (const ParseOptions& options : {ParseOptions{}, native_options}) {
+            double format_time = 0, format_allocations = 0, schema_time = 0, schema_allocations = 0;
+            measure([&] { Config::parse_buffer(content, root, options); }, format_time, format_allocations);
+            measure([&] { Config::parse_buffer(content, schema, options); }, schema_time, schema_allocations);
+
+            std::printf("%-9s   %16.2f   %15.2f   %14.2f   %13.1f   %13.1f\n",
+                        options.native_parser ? "native" : "confuse", format_time, schema_time,
+                        format_time - schema_time, format_allocations, schema_allocations);
+            std::fflush(stdout);
+        }
+    }
+
+    /**
+     * @brief benchmark_mapping time of the native parse of a file through a memory mapping against stdio
+     *
+     * The file repeats two options, so the tree doesn't grow with it and only the reading of the file differs. The
+     * file was just written, so both read it from the page cache.
+     */
+    void benchmark_mapping(size_t limit) {
+        ConfigFormat root{Option<int>("value"), Option<std::string>("name")};
+        path file_path = std::experimental::filesystem::temp_directory_path() / "confusepp-benchmark-mapping.conf";
+        std::string block;
+        for (int i = 0; i < 1024; ++i) {
+            block += "value = " + std::to_string(100000 + i) + "\nname = \"name of " + std::to_string(i) + "\"\n";
+        }
+
+        std::printf("file size MB   stdio ms   stdio MB/s   mapped ms   mapped MB/s\n");
+
+        for (size_t megabytes = 1; megabytes <= limit; megabytes *= 10) {
+            size_t file_size = megabytes << 20;
+            std::unique_ptr<FILE, decltype(&std::fclose)> file(std::fopen(file_path.c_str(), "wb"), &std::fclose);
+
+            for (size_t written = 0; written < file_size; written += block.size()) {
+                std::fwrite(block.data(), 1, block.size(), file.get());
+            }
+            file.reset();
+
+            // The faster of two runs, the first one may still fault the pages of the file in
+            auto measure = [&root, &file_path](bool memory_map) {
+                ParseOptions options;
+                options.native_parser = true;
+                options.memory_map = memory_map;
+                double fastest = 0;
+
+                for (int run = 0; run < 2; ++run) {
+                    double elapsed = milliseconds([&] {
+                        if (!Config::parse(file_path, root, options)) {
+                            std::abort();
+                        }
+                    });
+                    fastest = run == 0 ? elapsed : std::min(fastest, elapsed);
+                }
+                return fastest;
+            };
+
+            double with_stdio = measure(false);
+            double mapped = measure(true);
+            std::printf("%12zu   %8.1f   %10.0f   %9.1f   %11.0f\n", megabytes, with_stdio,
+                        megabytes * 1000 / with_stdio, mapped, megabytes * 1000 / mapped);
+            std::fflush(stdout);
+        }
+
+        std::experimental::filesystem::remove(file_path);
+    }
+
+}  // namespace
+
+/**
+ * Measurements of the claims of the library, configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+ *
+ * Usage: benchmark_confusepp [benchmark] [limit]
+ *   titles    loading 1k up to limit (default 1M) titled sections
+ *   lookups   allocations and time of limit (default 1M) lookups with get, find and bind
+ *   schema    time of limit (default 10k) parses with a ConfigFormat and with a CompiledSchema
+ *   mapping   native parse of 1MB up to limit (default 1024) MB files through a memory mapping and through stdio
+ */
+int main(int argc, char* argv[]) {
+    std::string_view benchmark = argc > 1 ? argv[1] : "all";
+    size_t limit = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+
+    if (benchmark == "titles" || benchmark == "all") {
+        benchmark_titles(limit ? limit : 1000000);
+    }
+
+    if (benchmark == "lookups" || benchmark == "all") {
+        benchmark_lookups(limit ? limit : 1000000);
+    }
+
+    if (benchmark == "schema" || benchmark == "all") {
+        benchmark_schema(limit ? limit : 10000);
+    }
+
+    if (benchmark == "mapping" || benchmark == "all") {
+        benchmark_mapping(limit ? limit : 1024);
+    }
+
+    return 0;
+}
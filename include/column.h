@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace confusepp {
+
+    template<typename T>
+    /**
+     * @brief Type in which a column stores the values of Option<T>, strings refer to the loaded values
+     */
+    using column_value_type =
+        std::conditional_t<std::is_same_v<T, bool>, uint8_t,
+                           std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>>;
+
+    /**
+     * @brief The ColumnBase class, type erased base of all columns
+     */
+    class ColumnBase {
+       public:
+        virtual ~ColumnBase() = default;
+    };
+
+    template<typename T>
+    /**
+     * @brief The Column class, one field of every titled section of a Multisection in contiguous storage
+     */
+    class Column final : public ColumnBase {
+       public:
+        using value_type = column_value_type<T>;
+
+        const std::vector<value_type>& values() const;
+        const std::vector<std::string_view>& titles() const; /**< titles parallel to values */
+        size_t size() const;
+
+       private:
+        std::vector<value_type> m_values;
+        std::vector<std::string_view> m_titles;
+
+        friend class Multisection;
+    };
+
+    /**
+     * @brief The ColumnCache class, columns which are built on first request
+     *
+     * The columns refer to the sections they were built from, so copies of the cache start empty and moves take the
+     * columns along with the sections. Building a column publishes a new immutable snapshot of the lookup table, so a
+     * column which was built once is found without a lock and without an allocation.
+     */
+    class ColumnCache final {
+       public:
+        ColumnCache() = default;
+        ColumnCache(const ColumnCache& cache);            /**< Copyconstructor, doesn't copy the columns */
+        ColumnCache& operator=(const ColumnCache& cache); /**< Copyassignment, clears the columns */
+        ColumnCache(ColumnCache&& cache);                 /**< Moveconstructor, takes the published columns */
+        ColumnCache& operator=(ColumnCache&& cache);      /**< Moveassignment, takes the published columns */
+
+        template<typename T, typename Builder>
+        /**
+         * @brief get the column of the field, build it if it wasn't requested before
+         * @param field path of the field inside of every section
+         * @param build fills the column and returns false if the column can't be built
+         * @return Pointer to the column or nullptr if it can't be built
+         */
+        const Column<T>* get(std::string_view field, Builder build) const;
+        /**
+         * @brief clear remove every column, must not run concurrently with get
+         */
+        void clear();
+
+       private:
+        using column_map = std::map<std::type_index, std::map<std::string, const ColumnBase*, std::less<>>>;
+
+        /**
+         * @brief find the column of the field in a snapshot
+         * @return Pointer to the entry, whose column is nullptr if it can't be built, or nullptr if there is no entry
+         */
+        static const ColumnBase* const* find(const column_map* snapshot, std::string_view field,
+                                             std::type_index type);
+
+        mutable std::mutex m_mutex;
+        mutable std::atomic<const column_map*> m_current = nullptr;
+        /**
+         * @brief m_snapshots every published snapshot, readers may still use an older one until clear is called
+         */
+        mutable std::vector<std::unique_ptr<const column_map>> m_snapshots;
+        mutable std::vector<std::unique_ptr<ColumnBase>> m_columns;
+    };
+
+    template<typename T>
+    const std::vector<typename Column<T>::value_type>& Column<T>::values() const {
+        return m_values;
+    }
+
+    template<typename T>
+    const std::vector<std::string_view>& Column<T>::titles() const {
+        return m_titles;
+    }
+
+    template<typename T>
+    size_t Column<T>::size() const {
+        return m_values.size();
+    }
+
+    inline ColumnCache::ColumnCache(const ColumnCache&) : ColumnCache() {}
+
+    inline ColumnCache& ColumnCache::operator=(const ColumnCache&) {
+        clear();
+        return *this;
+    }
+
+    inline ColumnCache::ColumnCache(ColumnCache&& cache) : ColumnCache() { *this = std::move(cache); }
+
+    inline ColumnCache& ColumnCache::operator=(ColumnCache&& cache) {
+        if (this == &cache) {
+            return *this;
+        }
+
+        std::scoped_lock lock(m_mutex, cache.m_mutex);
+        m_current.store(cache.m_current.exchange(nullptr, std::memory_order_relaxed), std::memory_order_release);
+        m_snapshots = std::move(cache.m_snapshots);
+        m_columns = std::move(cache.m_columns);
+        cache.m_snapshots.clear();
+        cache.m_columns.clear();
+        return *this;
+    }
+
+    inline void ColumnCache::clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_current.store(nullptr, std::memory_order_relaxed);
+        m_snapshots.clear();
+        m_columns.clear();
+    }
+
+    inline const ColumnBase* const* ColumnCache::find(const column_map* snapshot, std::string_view field,
+                                                      std::type_index type) {
+        if (!snapshot) {
+            return nullptr;
+        }
+
+        auto columns_of_type = snapshot->find(type);
+
+        if (columns_of_type == snapshot->cend()) {
+            return nullptr;
+        }
+
+        auto found = columns_of_type->second.find(field);
+        return found != columns_of_type->second.cend() ? &found->second : nullptr;
+    }
+
+    template<typename T, typename Builder>
+    const Column<T>* ColumnCache::get(std::string_view field, Builder build) const {
+        std::type_index type(typeid(T));
+
+        if (auto found = find(m_current.load(std::memory_order_acquire), field, type)) {
+            return static_cast<const Column<T>*>(*found);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const column_map* current = m_current.load(std::memory_order_relaxed);
+
+        // Another thread may have built the column while this one waited for the lock
+        if (auto found = find(current, field, type)) {
+            return static_cast<const Column<T>*>(*found);
+        }
+
+        auto column = std::make_unique<Column<T>>();
+        const Column<T>* built = nullptr;
+
+        if (build(*column)) {
+            built = column.get();
+            m_columns.push_back(std::move(column));
+        }
+
+        auto snapshot = current ? std::make_unique<column_map>(*current) : std::make_unique<column_map>();
+        (*snapshot)[type].emplace(std::string(field), built);
+        m_current.store(snapshot.get(), std::memory_order_release);
+        m_snapshots.push_back(std::move(snapshot));
+
+        return built;
+    }
+
+}  // namespace confusepp
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "elements.h"
+
+namespace confusepp {
+
+    /**
+     * @brief The CompiledSchema class, a ConfigFormat together with its confuse representation
+     *
+     * The confuse representation is built once, so parsing many files with the same schema only copies the
+     * prototype tree for every Config. A CompiledSchema is immutable after construction, so it can be shared between
+     * threads. It can't be copied or moved, because the confuse representation refers to the prototype tree.
+     */
+    class CompiledSchema final {
+       public:
+        /**
+         * @brief compile the schema
+         * @param root root-element of the config_tree
+         * @return Schema which can be passed to any number of Config::parse calls
+         */
+        static std::shared_ptr<const CompiledSchema> compile(ConfigFormat root);
+
+        explicit CompiledSchema(ConfigFormat root);
+        CompiledSchema(const CompiledSchema& schema) = delete;
+        CompiledSchema& operator=(const CompiledSchema& schema) = delete;
+
+        const ConfigFormat& prototype() const; /**< the tree every Config starts with */
+        /**
+         * @brief options the confuse representation of the root section
+         * @return Array of the options terminated by CFG_END(), confuse only reads it
+         */
+        cfg_opt_t* options() const;
+
+       private:
+        ConfigFormat m_prototype;
+        std::vector<std::unique_ptr<cfg_opt_t[]>> m_opt_storage;
+        cfg_opt_t* m_options = nullptr;
+    };
+
+}  // namespace confusepp
@@ -1,14 +1,83 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <type_traits>
 #include <vector>
 
+#include "compiled_schema.h"
 #include "elements.h"
+#include "flat_tree.h"
+#include "hot_block.h"
+#include "native_parser.h"
+#include "path_index.h"
+#include "query.h"
 
 namespace confusepp {
 
+    template<typename T>
+    /**
+     * @brief The Binding class, a pre-resolved handle to an Element of a Config
+     */
+    class Binding final {
+       public:
+        Binding() = default;
+
+        const T& operator*() const;
+        const T* operator->() const;
+        const T* get() const;
+        explicit operator bool() const;
+
+       private:
+        /**
+         * @brief Construct the Binding with the element it refers to
+         * @param element element inside the config_tree of a Config
+         */
+        explicit Binding(const T* element);
+
+        const T* m_element = nullptr;
+
+        friend class Config;
+    };
+
+    /**
+     * @brief The ParseOptions struct, optional features of Config::parse
+     *
+     * Every parse method can be called from several threads at once. The lexer of libconfuse keeps global state,
+     * so parses through libconfuse are serialized, parses with native_parser run concurrently.
+     */
+    struct ParseOptions {
+        bool build_path_index = false; /**< index every fully qualified path, see Config::path_index */
+        /**
+         * @brief memory_map the native_parser and Config::stream read the config file through a memory mapping
+         * instead of stdio
+         *
+         * Does nothing for parses through libconfuse, which always reads through stdio, it would wrap a mapped buffer
+         * in a stdio stream anyway. The file must not be truncated while it is parsed, a file which changed its size
+         * since it was opened is read through stdio.
+         */
+        bool memory_map = false;
+        bool native_parser = false;    /**< parse with NativeParser instead of libconfuse, reload uses libconfuse */
+        size_t parse_threads = 1;      /**< threads of the native_parser, which parse the top-level sections */
+        /**
+         * @brief projection path prefixes which are loaded, the other top-level elements keep their defaults
+         *
+         * The native_parser skips the content of the other elements with a scan for the matching brace, libconfuse
+         * still parses them, but they aren't loaded into the config_tree. Empty loads everything. A struct binding
+         * of the root is loaded completely, a bound Multisection only if it is projected.
+         */
+        std::vector<std::string> projection;
+        /**
+         * @brief lazy_load convert the value of an Option on its first use instead of while loading
+         *
+         * The values stay in the confuse handle until then, which the Config keeps. Not used by the native_parser,
+         * which converts every value while parsing.
+         */
+        bool lazy_load = false;
+    };
+
     /**
      * @brief The Config class which provides the content of the ConfigFile
      */
@@ -25,9 +94,82 @@ namespace confusepp {
          * @brief Parse-method which creats the config_tree from the config_file
          * @param config_file File which provides the config
          * @param root root-element of the config_tree
+         * @param options optional features, which are applied after the config is loaded
+         * @return Empty or filled Config-Instance
+         */
+        static std::optional<Config> parse(const path& config_file, ConfigFormat root, ParseOptions options = {});
+
+        /**
+         * @brief Parse-method which reuses a schema, which was compiled once
+         * @param config_file File which provides the config
+         * @param schema compiled schema, which is kept alive by the Config
+         * @param options optional features, which are applied after the config is loaded
          * @return Empty or filled Config-Instance
          */
-        static std::optional<Config> parse(const path& config_file, ConfigFormat root);
+        static std::optional<Config> parse(const path& config_file, std::shared_ptr<const CompiledSchema> schema,
+                                           ParseOptions options = {});
+
+        /**
+         * @brief parse_buffer create the config_tree from a config in memory, without a file
+         * @param buffer content of the config
+         * @param root root-element of the config_tree
+         * @param options optional features, which are applied after the config is loaded
+         * @return Empty or filled Config-Instance, which can't be reloaded
+         */
+        static std::optional<Config> parse_buffer(std::string_view buffer, ConfigFormat root,
+                                                  ParseOptions options = {});
+
+        /**
+         * @brief parse_buffer create the config_tree from a config in memory, which includes other files
+         * @param buffer content of the config
+         * @param include_directory directory which is searched for included files
+         * @param root root-element of the config_tree
+         * @param options optional features, which are applied after the config is loaded
+         * @return Empty or filled Config-Instance, which can't be reloaded
+         */
+        static std::optional<Config> parse_buffer(std::string_view buffer, const path& include_directory,
+                                                  ConfigFormat root, ParseOptions options = {});
+
+        /**
+         * @brief parse_buffer create the config_tree from a config in memory with a compiled schema
+         * @param buffer content of the config
+         * @param schema compiled schema, which is kept alive by the Config
+         * @param options optional features, which are applied after the config is loaded
+         * @return Empty or filled Config-Instance, which can't be reloaded
+         */
+        static std::optional<Config> parse_buffer(std::string_view buffer, std::shared_ptr<const CompiledSchema> schema,
+                                                  ParseOptions options = {});
+
+        /**
+         * @brief stream parse a config file with the NativeParser, but hand every titled section of a top-level
+         * Multisection to the visitor instead of keeping it in the config_tree, see NativeParser::stream
+         *
+         * The file is read through a memory mapping with ParseOptions::memory_map, in chunks otherwise. The options
+         * parse_threads, projection and lazy_load aren't supported, a stream with them set fails.
+         * @param config_file File which provides the config
+         * @param root root-element of the config_tree
+         * @param multisection identifier of the Multisection, which stays empty in the Config
+         * @param visitor called with every titled section, the reference is only valid during the call
+         * @param options optional features, which are applied after the config is loaded
+         * @return Empty or filled Config-Instance, which can't be reloaded
+         */
+        static std::optional<Config> stream(const path& config_file, ConfigFormat root, std::string_view multisection,
+                                            const NativeParser::section_visitor& visitor, ParseOptions options = {});
+
+        /**
+         * @brief reload parse the config file again and load it into the existing config_tree
+         *
+         * Options which were removed from the file get the default of the schema again.
+         * @return false if the file can't be parsed, the Config keeps its current values in that case, or if a
+         * field of a hot block doesn't exist anymore, the tree has the new values then and the block is invalid
+         *
+         * Pointers to elements stay valid, pointers to titled sections of a Multisection, columns and results of
+         * find_equal, find_range or queries do not.
+         *
+         * The tree and the hot blocks are written in place without synchronization, reload must not run while other
+         * threads read the Config, its elements or its hot blocks.
+         */
+        bool reload();
 
         template<typename T>
         /**
@@ -37,19 +179,158 @@ namespace confusepp {
          */
         std::optional<T> get(const path& element_path) const;
 
+        template<typename T>
+        /**
+         * @brief find the Element at the specified path without copying it
+         * @param element_path of the element
+         * @return Pointer into the config_tree, which is valid as long as the Config lives, or nullptr
+         */
+        const T* find(const path& element_path) const;
+
+        template<typename T>
+        /**
+         * @brief bind resolve the path once and return a handle to the Element
+         * @param element_path of the element
+         * @return Binding which stays valid as long as the Config lives, empty if there is no such element
+         */
+        Binding<T> bind(const path& element_path) const;
+
+        template<typename T, typename S, if_string_view<S> = 0>
+        /**
+         * @brief get the Element at the specified path without building a path object
+         * @param element_path of the element
+         * @return Element at the specified path
+         */
+        std::optional<T> get(const S& element_path) const;
+
+        template<typename T, typename S, if_string_view<S> = 0>
+        /**
+         * @brief find the Element at the specified path without building a path object
+         * @param element_path of the element
+         * @return Pointer into the config_tree or nullptr
+         */
+        const T* find(const S& element_path) const;
+
+        template<typename T, typename S, if_string_view<S> = 0>
+        /**
+         * @brief bind the Element at the specified path without building a path object
+         * @param element_path of the element
+         * @return Binding which stays valid as long as the Config lives, empty if there is no such element
+         */
+        Binding<T> bind(const S& element_path) const;
+
+        template<typename T>
+        /**
+         * @brief get the Element at the specified path, which was already split at compile time
+         * @param element_path of the element
+         * @return Element at the specified path
+         */
+        std::optional<T> get(const SplitPath& element_path) const;
+
+        template<typename T>
+        /**
+         * @brief find the Element at the specified path, which was already split at compile time
+         * @param element_path of the element
+         * @return Pointer into the config_tree or nullptr
+         */
+        const T* find(const SplitPath& element_path) const;
+
+        template<typename T>
+        /**
+         * @brief bind the Element at the specified path, which was already split at compile time
+         * @param element_path of the element
+         * @return Binding which stays valid as long as the Config lives, empty if there is no such element
+         */
+        Binding<T> bind(const SplitPath& element_path) const;
+
+        /**
+         * @brief find_batch resolve many paths at once, every shared prefix is only walked once
+         * @param paths which are resolved
+         * @param count number of paths
+         * @param results caller provided array with space for count results, empty if there is no such element
+         */
+        void find_batch(const std::string_view* paths, size_t count, ElementRef* results) const;
+
+        template<typename T>
+        /**
+         * @brief query collect the results of type T of a compiled query
+         * @param query compiled query
+         * @param results cleared and filled with pointers into the config_tree, reusing the vector avoids allocations
+         */
+        void query(const Query& query, std::vector<const T*>& results) const;
+
+        template<typename F>
+        /**
+         * @brief for_each run a compiled query and call the callback with an ElementRef for every result
+         * @param query compiled query
+         * @param callback which is called for every result
+         */
+        void for_each(const Query& query, F callback) const;
+
+        template<typename Struct>
+        /**
+         * @brief hot_block copy the values of a few Options into a cache-line aligned struct
+         * @param fields paths and the members of the struct which receive the values
+         * @return Block which is owned by the Config and refreshed on every reload, or nullptr if a field doesn't
+         * exist, see HotBlock::valid
+         */
+        const HotBlock<Struct>* hot_block(std::vector<HotField<Struct>> fields);
+
+        template<typename Struct>
+        /**
+         * @brief bound the struct which was loaded for the root, see Section::bind
+         * @return Pointer which is valid as long as the Config lives, or nullptr if the root isn't bound to a Struct
+         */
+        const Struct* bound() const;
+
+        /**
+         * @brief flatten copy the config_tree into a FlatTree, which is independent of this Config
+         * @return Read-only snapshot of all loaded values in one contiguous arena
+         */
+        FlatTree flatten() const;
+
+        /**
+         * @brief path_index the index of all fully qualified paths, empty unless ParseOptions::build_path_index
+         * @return index which is used by get, find and bind for paths without leading, trailing or repeated '/'
+         */
+        const PathIndex& path_index() const;
+
        private:
         /**
          * @brief Constuct the Config with the
          * @param config_tree Tree represantation of the config
+         * @param options optional features of the config
          * @param config_handle the confuse handle for the root section
          */
-        Config(ConfigFormat config_tree, cfg_t* config_handle = nullptr);
+        Config(ConfigFormat config_tree, ParseOptions options = {}, cfg_t* config_handle = nullptr);
 
         /**
          * @brief config_handle Initialize the config-tree
          * @param handle root handle from confuse
+         * @return result of finish_loading
          */
-        void config_handle(cfg_t* handle);
+        bool config_handle(cfg_t* handle);
+
+        /**
+         * @brief parse_native load the config with the NativeParser into the config_tree
+         * @param buffer content of the config or nullptr to read m_config_path
+         * @return false if the config can't be read or parsed
+         */
+        bool parse_native(const std::string_view* buffer);
+
+        /**
+         * @brief build_confuse_options build the options for libconfuse from the config_tree, before it is loaded
+         *
+         * The names and string defaults are copied, so the options keep the original defaults for reload.
+         * @return the options of the root section, which are owned by the Config
+         */
+        cfg_opt_t* build_confuse_options();
+
+        /**
+         * @brief finish_loading update everything which is derived from the loaded config_tree
+         * @return false if a hot block can't be refreshed
+         */
+        bool finish_loading();
 
         /**
          * @brief m_valid runtime check for config tree
@@ -61,10 +342,130 @@ namespace confusepp {
          * @brief m_opt_storage Storage for the confuse representation
          */
         std::vector<std::unique_ptr<cfg_opt_t[]>> m_opt_storage;
+        /**
+         * @brief m_string_storage the names and string defaults of m_opt_storage
+         */
+        std::vector<std::unique_ptr<char[]>> m_string_storage;
+        /**
+         * @brief m_confuse_options the options of the root section in m_opt_storage, nullptr if they weren't built
+         */
+        cfg_opt_t* m_confuse_options = nullptr;
+        ParseOptions m_options;
+        PathIndex m_path_index;
+        path m_config_path;
+        std::vector<std::unique_ptr<HotBlockBase>> m_hot_blocks;
+        /**
+         * @brief m_lazy_mutex guards the first conversion of the lazy loaded Options of this Config
+         */
+        std::unique_ptr<std::mutex> m_lazy_mutex;
+        /**
+         * @brief m_schema the schema the Config was parsed with, its options are used instead of m_opt_storage
+         */
+        std::shared_ptr<const CompiledSchema> m_schema;
     };
 
     template<typename T>
     std::optional<T> Config::get(const path& element_path) const {
+        return get<T>(std::string_view(element_path.native()));
+    }
+
+    template<typename T>
+    const T* Config::find(const path& element_path) const {
+        return find<T>(std::string_view(element_path.native()));
+    }
+
+    template<typename T>
+    Binding<T> Config::bind(const path& element_path) const {
+        return Binding<T>(find<T>(element_path));
+    }
+
+    template<typename T, typename S, if_string_view<S>>
+    std::optional<T> Config::get(const S& element_path) const {
+        if (auto element = find<T>(element_path)) {
+            return std::optional<T>(*element);
+        }
+        return {};
+    }
+
+    template<typename T, typename S, if_string_view<S>>
+    const T* Config::find(const S& element_path) const {
+        std::string_view element_path_view(element_path);
+
+        if (!m_path_index.empty() && PathIndex::is_canonical(element_path_view)) {
+            return m_path_index.find<T>(element_path_view);
+        }
+
+        return m_config_tree.find<T>(element_path_view);
+    }
+
+    template<typename T, typename S, if_string_view<S>>
+    Binding<T> Config::bind(const S& element_path) const {
+        return Binding<T>(find<T>(element_path));
+    }
+
+    template<typename T>
+    std::optional<T> Config::get(const SplitPath& element_path) const {
         return m_config_tree.get<T>(element_path);
     }
+
+    template<typename T>
+    const T* Config::find(const SplitPath& element_path) const {
+        return m_config_tree.find<T>(element_path);
+    }
+
+    template<typename T>
+    Binding<T> Config::bind(const SplitPath& element_path) const {
+        return Binding<T>(find<T>(element_path));
+    }
+
+    template<typename T>
+    void Config::query(const Query& query, std::vector<const T*>& results) const {
+        query.collect<T>(m_config_tree, results);
+    }
+
+    template<typename F>
+    void Config::for_each(const Query& query, F callback) const {
+        query.for_each(m_config_tree, std::move(callback));
+    }
+
+    template<typename Struct>
+    const HotBlock<Struct>* Config::hot_block(std::vector<HotField<Struct>> fields) {
+        auto block = std::make_unique<HotBlock<Struct>>(std::move(fields));
+
+        if (!block->refresh(m_config_tree)) {
+            return nullptr;
+        }
+
+        auto created_block = block.get();
+        m_hot_blocks.push_back(std::move(block));
+        return created_block;
+    }
+
+    template<typename Struct>
+    const Struct* Config::bound() const {
+        return m_config_tree.bound<Struct>();
+    }
+
+    template<typename T>
+    Binding<T>::Binding(const T* element) : m_element(element) {}
+
+    template<typename T>
+    const T& Binding<T>::operator*() const {
+        return *m_element;
+    }
+
+    template<typename T>
+    const T* Binding<T>::operator->() const {
+        return m_element;
+    }
+
+    template<typename T>
+    const T* Binding<T>::get() const {
+        return m_element;
+    }
+
+    template<typename T>
+    Binding<T>::operator bool() const {
+        return m_element != nullptr;
+    }
 }  // namespace confusepp
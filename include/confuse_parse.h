@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string_view>
+
+#include <confuse.h>
+
+#include "elements.h"
+
+namespace confusepp {
+
+    // The parse_config functions can be called from several threads, they take a lock around the lexer of confuse
+
+    /**
+     * @brief parse_config_file parse a config file with the given structure
+     * @param config_path path of the config file, its directory is added to the search path for includes
+     * @param options confuse representation of the root section, terminated by CFG_END()
+     * @return confuse handle of the parsed file or nullptr
+     */
+    cfg_t* parse_config_file(const path& config_path, cfg_opt_t* options);
+
+    /**
+     * @brief parse_config_buffer parse a config which is already in memory
+     * @param buffer content of the config, doesn't have to be null terminated
+     * @param options confuse representation of the root section, terminated by CFG_END()
+     * @param include_directory directory which is searched for included files, nothing is added if it is empty
+     * @return confuse handle of the parsed config or nullptr
+     */
+    cfg_t* parse_config_buffer(std::string_view buffer, cfg_opt_t* options, const path& include_directory = {});
+
+}  // namespace confusepp
@@ -1,4 +1,9 @@
 #pragma once
 
+#include "compiled_schema.h"
 #include "config.h"
 #include "elements.h"
+#include "flat_tree.h"
+#include "native_parser.h"
+#include "query.h"
+#include "static_format.h"
@@ -1,25 +1,42 @@
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 
+#include <atomic>
 #include <experimental/filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
 #include <confuse.h>
 
+#include "column.h"
+#include "field_index.h"
+#include "path_segments.h"
+#include "perfect_hash.h"
+#include "split_path.h"
+#include "struct_binding.h"
+
 namespace confusepp {
 
     using path = std::experimental::filesystem::path;
 
+    template<typename S>
+    using if_string_view = std::enable_if_t<std::is_convertible_v<const S&, std::string_view>, int>;
+
     template<typename T>
     class Option;       /**< Forwarddeclaration */
     class Section;      /**< Forwarddeclaration */
     class Multisection; /**< Forwarddeclaration */
+    class ElementRef;   /**< Forwarddeclaration */
 
     template<typename T>
     /**
@@ -54,7 +71,10 @@ namespace confusepp {
         void update_list(cfg_t* parent, const std::string& identifier, F f);
 
         size_t m_buffer_size = 0;
-        std::unique_ptr<char[]> m_default_value_buf = nullptr;
+        /**
+         * @brief m_default_value_buf confuse representation of the default, it never changes, so copies share it
+         */
+        std::shared_ptr<char[]> m_default_value_buf = nullptr;
 
         template<typename E>
         friend class Option;
@@ -67,6 +87,10 @@ namespace confusepp {
        public:
         Element(const std::string& identifier);
         virtual ~Element() = default;
+        Element(const Element& element) = default;            /**< Copyconstructor */
+        Element(Element&& element) = default;                 /**< Moveconstructor */
+        Element& operator=(const Element& element) = default; /**< Copyassignment */
+        Element& operator=(Element&& element) = default;      /**< Moveassignment */
 
         const std::string& identifier() const;
 
@@ -79,7 +103,7 @@ namespace confusepp {
         Function(const std::string& identifier, cfg_func_t function);
         virtual ~Function() = default;
 
-        void load(cfg_t* parent_handle);
+        void load(cfg_t* parent_handle, std::mutex* lazy = nullptr);
 
        private:
         cfg_opt_t get_confuse_representation() const;
@@ -99,22 +123,44 @@ namespace confusepp {
        public:
         Option(const std::string& identifier);
         virtual ~Option() = default;
+        Option(const Option& option);            /**< Copyconstructor, converts a lazy loaded value first */
+        Option(Option&& option);                 /**< Moveconstructor, a lazy loaded value stays unconverted */
+        Option& operator=(const Option& option); /**< Copyassignment, converts a lazy loaded value first */
 
         template<typename... Args>
         const Option<T>& default_value(Args... args);
+        /**
+         * @brief value of the Option, a lazy loaded value is converted by the first call
+         * @return Reference to the value, which stays valid as long as the Option
+         */
         const T& value() const;
 
        private:
         const T& value(cfg_t* parent) const;
         cfg_opt_t get_confuse_representation() const;
-        void load(cfg_t* parent_handle);
+        /**
+         * @brief load the value from the handle of the parent section
+         * @param lazy if set, keep the handle and convert the value when it is used for the first time, the mutex of
+         * the Config guards the conversion
+         */
+        void load(cfg_t* parent_handle, std::mutex* lazy = nullptr);
+        void convert_pending_value() const;
 
         mutable T m_value;
         bool m_has_default_value;
+        /**
+         * @brief m_pending_handle handle of the parent section, as long as a lazy loaded value isn't converted
+         */
+        mutable std::atomic<cfg_t*> m_pending_handle = nullptr;
+        /**
+         * @brief m_lazy_mutex guards the conversion of a lazy loaded value, later reads don't take it
+         */
+        std::mutex* m_lazy_mutex = nullptr;
 
         friend class Section;
         friend class Multisection;
         friend class ConfigFormat;
+        friend class NativeParser;
     };
 
     class Section : public Element {
@@ -126,32 +172,110 @@ namespace confusepp {
 
         Section(const std::string& identifier);
         virtual ~Section() = default;
+        Section(const Section& section) = default;            /**< Copyconstructor, shares the child hash */
+        Section(Section&& section) = default;                 /**< Moveconstructor */
+        Section& operator=(const Section& section) = default; /**< Copyassignment */
+        Section& operator=(Section&& section) = default;      /**< Moveassignment */
 
         template<typename T>
         std::optional<T> get(const path& element_path) const;
+        template<typename T>
+        const T* find(const path& element_path) const;
+        template<typename T, typename S, if_string_view<S> = 0>
+        std::optional<T> get(const S& element_path) const;
+        template<typename T, typename S, if_string_view<S> = 0>
+        const T* find(const S& element_path) const;
+        template<typename T>
+        std::optional<T> get(const SplitPath& element_path) const;
+        template<typename T>
+        const T* find(const SplitPath& element_path) const;
+        /**
+         * @brief find_batch resolve many paths at once, every shared prefix is only walked once
+         * @param paths which are resolved
+         * @param count number of paths
+         * @param results caller provided array with space for count results, empty if there is no such element
+         */
+        void find_batch(const std::string_view* paths, size_t count, ElementRef* results) const;
         std::optional<variant_type> operator[](const std::string& identifier) const;
         const std::string& title() const;
         template<typename... Args>
         Section& values(Args... args);
+        template<typename Struct>
+        /**
+         * @brief bind load the options described by format directly into a struct, without Option elements
+         * @param format options of the section and the members which receive their values
+         */
+        Section& bind(StructFormat<Struct> format);
+        template<typename Struct>
+        /**
+         * @brief bound the struct which was loaded for this section, every copy of the section has its own
+         * @return nullptr if the section isn't bound to a Struct
+         */
+        const Struct* bound() const;
 
        protected:
         Section& title(const std::string& title);
         cfg_opt_t get_confuse_representation(option_storage& opt_storage) const;
-        virtual void load(cfg_t* parent_handle);
+        virtual void load(cfg_t* parent_handle, std::mutex* lazy = nullptr);
+        /**
+         * @brief load_values load the values of the children from the handle of this section
+         * @param section_handle confuse handle of this section
+         * @param lazy if set, only keep the handle in every Option, see Option::value
+         */
+        void load_values(cfg_t* section_handle, std::mutex* lazy = nullptr);
+        /**
+         * @brief load_projected load only the children which are selected by the projection, a struct binding of
+         * this section is loaded completely
+         * @param section_handle confuse handle of this section
+         * @param projection path prefixes, see NativeParser::is_projected
+         * @param lazy if set, only keep the handle in every Option, see Option::value
+         */
+        void load_projected(cfg_t* section_handle, const std::vector<std::string>& projection,
+                            std::mutex* lazy = nullptr);
 
        private:
-        template<typename T>
-        std::optional<T> get(path::iterator begin, path::iterator end) const;
+        /**
+         * @brief The ChildHash struct, perfect hash of the identifiers of the children to their position in m_values
+         *
+         * The identifiers are fixed once the schema is built, so the hash is built once for every node of the schema
+         * and shared by all copies of it. It owns the identifiers, which its keys and the keys of m_values refer to.
+         */
+        struct ChildHash {
+            std::vector<std::string> identifiers;
+            PerfectHash<uint32_t> positions;
+        };
+
+        template<typename T, typename Iterator>
+        const T* find(Iterator begin, Iterator end) const;
+        const variant_type* child(std::string_view identifier) const;
+        variant_type* child(std::string_view identifier);
+        static ElementRef child(const ElementRef& parent, std::string_view identifier);
         void add_children(std::vector<variant_type> values);
+        static const std::string& identifier_of(const std::pair<std::string_view, variant_type>& child);
+        void build_child_hash();
 
-        std::map<std::string, variant_type> m_values;
+        /**
+         * @brief m_values the children sorted by their identifier, every identifier appears only once
+         */
+        std::vector<std::pair<std::string_view, variant_type>> m_values;
         std::string m_title;
+        /**
+         * @brief m_child_hash shared by every copy of the schema node, nullptr without children, the positions are
+         * empty if no perfect hash was found
+         */
+        std::shared_ptr<const ChildHash> m_child_hash;
+        BoundStruct m_binding;
 
         template<typename T>
         friend class Option;
         friend class Multisection;
         friend class ConfigFormat;
         friend class Config;
+        friend class FlatTree;
+        friend class PathIndex;
+        friend class Query;
+        friend class CompiledSchema;
+        friend class NativeParser;
     };
 
     class Multisection final : public Element {
@@ -161,44 +285,165 @@ namespace confusepp {
 
         Multisection(const std::string& identifier);
         virtual ~Multisection() = default;
+        Multisection(const Multisection& multisection) = default;            /**< Copyconstructor */
+        Multisection(Multisection&& multisection) = default;                 /**< Moveconstructor */
+        Multisection& operator=(const Multisection& multisection) = default; /**< Copyassignment */
+        Multisection& operator=(Multisection&& multisection) = default;      /**< Moveassignment */
 
         template<typename T>
         std::optional<T> get(const path& element_path) const;
+        template<typename T>
+        const T* find(const path& element_path) const;
+        template<typename T, typename S, if_string_view<S> = 0>
+        std::optional<T> get(const S& element_path) const;
+        template<typename T, typename S, if_string_view<S> = 0>
+        const T* find(const S& element_path) const;
+        template<typename T>
+        std::optional<T> get(const SplitPath& element_path) const;
+        template<typename T>
+        const T* find(const SplitPath& element_path) const;
         std::optional<Section> operator[](const std::string& title) const;
-        std::vector<Section> sections() const;
+        /**
+         * @brief section find the titled section without copying it
+         * @param title of the section
+         * @return Pointer to the section or nullptr
+         */
+        const Section* section(std::string_view title) const;
+        /**
+         * @brief sections all titled sections in the order of the config file
+         * @return Reference to the stored sections, nothing is copied
+         */
+        const std::vector<Section>& sections() const;
+        template<typename T>
+        /**
+         * @brief column the values of one field of every titled section, built on first request and cached
+         * @tparam T type of the Option, the column stores bools as uint8_t and strings as std::string_view
+         * @param field path of an Option<T> inside of every section
+         * @return Pointer to the column, which stays valid as long as the Multisection, or nullptr if a section has
+         * no such field
+         */
+        const Column<T>* column(std::string_view field) const;
+        template<typename T, typename V>
+        /**
+         * @brief find_equal all titled sections in which the Option<T> at field equals value
+         * @param field path of the Option inside of every section
+         * @param value to compare with
+         * @return Sections in the order of the config file, uses the index of the field if there is one
+         */
+        std::vector<const Section*> find_equal(std::string_view field, const V& value) const;
+        template<typename T>
+        /**
+         * @brief find_range all titled sections in which the Option<T> at field is in [lower, upper)
+         * @param field path of the Option inside of every section
+         * @return Sections ordered by value if the field is indexed, otherwise in the order of the config file
+         */
+        std::vector<const Section*> find_range(std::string_view field, const T& lower, const T& upper) const;
         template<typename... Args>
         Multisection& values(Args... args);
+        template<typename Struct>
+        /**
+         * @brief bind load every titled section directly into a vector of structs, the titled sections aren't kept
+         * @param format options of the sections and the members which receive their values
+         */
+        Multisection& bind(StructFormat<Struct> format);
+        template<typename Struct>
+        /**
+         * @brief bound the structs which were loaded for the titled sections, in the order of the config file
+         * @return nullptr if the Multisection isn't bound to a Struct
+         */
+        const std::vector<Struct>* bound() const;
+        /**
+         * @brief index_on build an index over the field when loading, a hash index for an Option<std::string> and a
+         * sorted index for an Option<int> or Option<float>
+         * @param field path of the Option inside of every section
+         */
+        Multisection& index_on(const std::string& field);
 
        private:
-        template<typename T>
-        std::optional<T> get(path::iterator begin, path::iterator end) const;
+        template<typename T, typename Iterator>
+        const T* find(Iterator begin, Iterator end) const;
         cfg_opt_t get_confuse_representation(option_storage& opt_storage) const;
-        void load(cfg_t* parent_handle);
+        void load(cfg_t* parent_handle, std::mutex* lazy = nullptr);
+        /**
+         * @brief find_title index of the section with the title in m_sections
+         * @param title of the section
+         * @return index or m_sections.size() if there is no such section
+         */
+        size_t find_title(std::string_view title) const;
+        void index_title(uint32_t section_index);
+        void place_title(uint32_t section_index);
+        void build_indexes();
+
+        using index_type = std::variant<std::monostate, HashIndex, FieldIndex<int>, FieldIndex<float>>;
 
-        std::vector<variant_type> m_values;
-        mutable std::map<std::string, Section> m_sections;
+        /**
+         * @brief m_prototype the children of every titled section, new titled sections are copies of it
+         */
+        Section m_prototype;
+        std::vector<Section> m_sections;
+        /**
+         * @brief m_title_slots open addressing hash table of the titles, holds index + 1 into m_sections or 0
+         */
+        std::vector<uint32_t> m_title_slots;
+        ColumnCache m_columns;
+        std::map<std::string, index_type, std::less<>> m_indexes;
+        BoundStruct m_binding;
 
         template<typename T>
         friend class Option;
         friend class Section;
         friend class ConfigFormat;
+        friend class FlatTree;
+        friend class PathIndex;
+        friend class Query;
+        friend class NativeParser;
     };
 
     class ConfigFormat final : public Section {
        public:
         ConfigFormat(const std::initializer_list<variant_type>& values);
         virtual ~ConfigFormat() = default;
+        ConfigFormat(const ConfigFormat& configformat) = default;            /**< Copyconstructor */
+        ConfigFormat(ConfigFormat&& configformat) = default;                 /**< Moveconstructor */
+        ConfigFormat& operator=(const ConfigFormat& configformat) = default; /**< Copyassignment */
+        ConfigFormat& operator=(ConfigFormat&& configformat) = default;      /**< Moveassignment */
 
         /**
          * @brief load the values from the config with the confuse handle into the tree representation
          * @param parent_handle handle of the current top node
+         * @param lazy if set, only keep the handle in every Option, see Option::value
          */
-        void load(cfg_t* parent_handle) override;
+        void load(cfg_t* parent_handle, std::mutex* lazy = nullptr) override;
 
        private:
         friend class Config;
     };
 
+    /**
+     * @brief The ElementRef class, a non-owning reference to an Element of a loaded tree
+     *
+     * Either refers to an element stored in a Section or to a titled Section of a Multisection.
+     */
+    class ElementRef final {
+       public:
+        ElementRef() = default;
+        explicit ElementRef(const Section::variant_type* element);
+        explicit ElementRef(const Section* section);
+
+        template<typename T>
+        /**
+         * @brief get the referenced Element
+         * @return Pointer to the element or nullptr, if nothing is referenced or the element has a different type
+         */
+        const T* get() const;
+        const Section::variant_type* element() const;
+        explicit operator bool() const;
+
+       private:
+        const Section::variant_type* m_element = nullptr;
+        const Section* m_section = nullptr;
+    };
+
     template<typename T>
     void swap(List<T>& lhs, List<T>& rhs) {
         lhs.swap(rhs);
@@ -230,7 +475,7 @@ namespace confusepp {
         stream << "}";
 
         m_buffer_size = stream.str().size() + 1;
-        m_default_value_buf = std::make_unique<char[]>(m_buffer_size);
+        m_default_value_buf = std::shared_ptr<char[]>(new char[m_buffer_size]);
 
         if (m_buffer_size && m_default_value_buf) {
             std::strncpy(m_default_value_buf.get(), stream.str().c_str(), m_buffer_size);
@@ -239,13 +484,7 @@ namespace confusepp {
 
     template<typename T>
     List<T>::List(const List& list)
-        : std::vector<T>(list),
-          m_buffer_size(list.m_buffer_size),
-          m_default_value_buf(std::make_unique<char[]>(m_buffer_size)) {
-        if (m_buffer_size && m_default_value_buf && list.m_default_value_buf) {
-            std::strncpy(m_default_value_buf.get(), list.m_default_value_buf.get(), m_buffer_size);
-        }
-    }
+        : std::vector<T>(list), m_buffer_size(list.m_buffer_size), m_default_value_buf(list.m_default_value_buf) {}
 
     template<typename T>
     List<T>::List(List&& list)
@@ -358,15 +597,59 @@ namespace confusepp {
     }
 
     template<typename T>
-    void Option<T>::load(cfg_t* parent_handle) {
-        value(parent_handle);
+    Option<T>::Option(const Option& option)
+        : Element(option), m_value(option.value()), m_has_default_value(option.m_has_default_value) {}
+
+    template<typename T>
+    Option<T>::Option(Option&& option)
+        : Element(std::move(option)),
+          m_value(std::move(option.m_value)),
+          m_has_default_value(option.m_has_default_value),
+          m_pending_handle(option.m_pending_handle.exchange(nullptr)),
+          m_lazy_mutex(option.m_lazy_mutex) {}
+
+    template<typename T>
+    Option<T>& Option<T>::operator=(const Option& option) {
+        if (this != &option) {
+            Element::operator=(option);
+            m_value = option.value();
+            m_has_default_value = option.m_has_default_value;
+            m_pending_handle = nullptr;
+        }
+
+        return *this;
+    }
+
+    template<typename T>
+    void Option<T>::load(cfg_t* parent_handle, std::mutex* lazy) {
+        if (lazy) {
+            m_lazy_mutex = lazy;
+            m_pending_handle.store(parent_handle, std::memory_order_release);
+        } else {
+            m_pending_handle.store(nullptr, std::memory_order_relaxed);
+            value(parent_handle);
+        }
     }
 
     template<typename T>
     const T& Option<T>::value() const {
+        // Once the value is converted this is a single load, the lock is only taken by the first callers
+        if (m_pending_handle.load(std::memory_order_acquire)) {
+            convert_pending_value();
+        }
         return m_value;
     }
 
+    template<typename T>
+    void Option<T>::convert_pending_value() const {
+        std::lock_guard<std::mutex> lock(*m_lazy_mutex);
+
+        if (cfg_t* parent_handle = m_pending_handle.load(std::memory_order_relaxed)) {
+            value(parent_handle);
+            m_pending_handle.store(nullptr, std::memory_order_release);
+        }
+    }
+
     template<>
     inline const int& Option<int>::value(cfg_t* parent_handle) const {
         if (parent_handle) {
@@ -436,54 +719,90 @@ namespace confusepp {
         return m_value;
     }
 
+    template<typename T>
+    const T* ElementRef::get() const {
+        if constexpr (std::is_same_v<T, Section>) {
+            if (m_section) {
+                return m_section;
+            }
+        }
+
+        if (!m_element) {
+            return nullptr;
+        }
+
+        return std::get_if<T>(m_element);
+    }
+
     template<typename T>
     std::optional<T> Section::get(const path& element_path) const {
-        if (element_path.empty()) {
-            return {};
+        if (auto element = find<T>(element_path)) {
+            return std::optional<T>(*element);
         }
+        return {};
+    }
 
-        auto start = element_path.begin(), end = element_path.end();
-        std::string path = element_path.c_str();
+    template<typename T>
+    const T* Section::find(const path& element_path) const {
+        return find<T>(std::string_view(element_path.native()));
+    }
 
-        if (path[0] == '/') {
-            ++start;
+    template<typename T, typename S, if_string_view<S>>
+    std::optional<T> Section::get(const S& element_path) const {
+        if (auto element = find<T>(element_path)) {
+            return std::optional<T>(*element);
         }
+        return {};
+    }
+
+    template<typename T, typename S, if_string_view<S>>
+    const T* Section::find(const S& element_path) const {
+        PathSegments segments{std::string_view(element_path)};
 
-        if (path.size() > 1 && path[path.size() - 1] == '/') {
-            --end;
+        if (segments.empty()) {
+            return nullptr;
         }
 
-        return get<T>(start, end);
+        return find<T>(segments.begin(), segments.end());
     }
 
     template<typename T>
-    std::optional<T> Section::get(path::iterator current, path::iterator end) const {
-        auto next_element = m_values.find(current->c_str());
+    std::optional<T> Section::get(const SplitPath& element_path) const {
+        if (auto element = find<T>(element_path)) {
+            return std::optional<T>(*element);
+        }
+        return {};
+    }
+
+    template<typename T>
+    const T* Section::find(const SplitPath& element_path) const {
+        return find<T>(element_path.begin(), element_path.end());
+    }
+
+    template<typename T, typename Iterator>
+    const T* Section::find(Iterator current, Iterator end) const {
+        auto next_element = child(*current);
         ++current;
 
-        if (next_element == m_values.cend()) {
-            return {};
+        if (!next_element) {
+            return nullptr;
         }
 
         if (current == end) {
-            if (!std::holds_alternative<T>(next_element->second)) {
-                return {};
-            }
-
-            return std::optional<T>(std::get<T>(next_element->second));
+            return std::get_if<T>(next_element);
         }
 
         return std::visit(
-            [&current, &end](auto& child) -> std::optional<T> {
+            [&current, &end](auto& child) -> const T* {
                 using current_type = std::decay_t<decltype(child)>;
 
                 if constexpr (std::is_same_v<Section, current_type> || std::is_same_v<Multisection, current_type>) {
-                    return child.template get<T>(current, end);
+                    return child.template find<T>(current, end);
                 } else {
-                    return std::optional<T>{};
+                    return nullptr;
                 }
             },
-            next_element->second);
+            *next_element);
     }
 
     template<typename... Args>
@@ -494,49 +813,193 @@ namespace confusepp {
         return *this;
     }
 
+    template<typename Struct>
+    Section& Section::bind(StructFormat<Struct> format) {
+        m_binding = BoundStruct(std::make_unique<SectionBinding<Struct>>(std::move(format)));
+        return *this;
+    }
+
+    template<typename Struct>
+    const Struct* Section::bound() const {
+        auto binding = dynamic_cast<const SectionBinding<Struct>*>(m_binding.get());
+        return binding ? &binding->value() : nullptr;
+    }
+
     template<typename... Args>
     Multisection& Multisection::values(Args... args) {
-        m_values = std::vector<variant_type>({args...});
+        m_prototype.values(args...);
         return *this;
     }
 
+    template<typename T>
+    const Column<T>* Multisection::column(std::string_view field) const {
+        return m_columns.get<T>(field, [this, field](Column<T>& column) {
+            column.m_values.reserve(m_sections.size());
+            column.m_titles.reserve(m_sections.size());
+
+            for (const auto& section : m_sections) {
+                auto option = section.find<Option<T>>(field);
+
+                if (!option) {
+                    return false;
+                }
+
+                column.m_values.push_back(typename Column<T>::value_type(option->value()));
+                column.m_titles.push_back(section.title());
+            }
+
+            return true;
+        });
+    }
+
+    template<typename Struct>
+    Multisection& Multisection::bind(StructFormat<Struct> format) {
+        m_binding = BoundStruct(std::make_unique<MultisectionBinding<Struct>>(std::move(format), identifier()));
+        return *this;
+    }
+
+    template<typename Struct>
+    const std::vector<Struct>* Multisection::bound() const {
+        auto binding = dynamic_cast<const MultisectionBinding<Struct>*>(m_binding.get());
+        return binding ? &binding->values() : nullptr;
+    }
+
+    template<typename T, typename V>
+    std::vector<const Section*> Multisection::find_equal(std::string_view field, const V& value) const {
+        std::vector<const Section*> found_sections;
+        auto index = m_indexes.find(field);
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            auto string_index = index != m_indexes.cend() ? std::get_if<HashIndex>(&index->second) : nullptr;
+
+            if (string_index) {
+                std::string_view key(value);
+
+                // Only the hashes are indexed, the strings have to be compared to rule out collisions
+                for (const auto& [hash, section_index] : string_index->equal(seeded_hash(key, 0))) {
+                    auto option = m_sections[section_index].template find<Option<std::string>>(field);
+
+                    if (option && option->value() == key) {
+                        found_sections.push_back(&m_sections[section_index]);
+                    }
+                }
+
+                return found_sections;
+            }
+        } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, float>) {
+            auto typed_index = index != m_indexes.cend() ? std::get_if<FieldIndex<T>>(&index->second) : nullptr;
+
+            if (typed_index) {
+                for (const auto& [key, section_index] : typed_index->equal(value)) {
+                    found_sections.push_back(&m_sections[section_index]);
+                }
+
+                return found_sections;
+            }
+        }
+
+        for (const auto& section : m_sections) {
+            if (auto option = section.find<Option<T>>(field); option && option->value() == value) {
+                found_sections.push_back(&section);
+            }
+        }
+
+        return found_sections;
+    }
+
+    template<typename T>
+    std::vector<const Section*> Multisection::find_range(std::string_view field, const T& lower,
+                                                         const T& upper) const {
+        std::vector<const Section*> found_sections;
+
+        if constexpr (std::is_same_v<T, int> || std::is_same_v<T, float>) {
+            auto index = m_indexes.find(field);
+            auto typed_index = index != m_indexes.cend() ? std::get_if<FieldIndex<T>>(&index->second) : nullptr;
+
+            if (typed_index) {
+                auto found = typed_index->range(lower, upper);
+                found_sections.reserve(found.size());
+
+                for (const auto& [key, section_index] : found) {
+                    found_sections.push_back(&m_sections[section_index]);
+                }
+
+                return found_sections;
+            }
+        }
+
+        for (const auto& section : m_sections) {
+            if (auto option = section.find<Option<T>>(field);
+                option && !(option->value() < lower) && option->value() < upper) {
+                found_sections.push_back(&section);
+            }
+        }
+
+        return found_sections;
+    }
+
     template<typename T>
     std::optional<T> Multisection::get(const path& element_path) const {
-        if (element_path.empty()) {
-            return {};
+        if (auto element = find<T>(element_path)) {
+            return std::optional<T>(*element);
         }
+        return {};
+    }
 
-        auto start = element_path.begin(), end = element_path.end();
-        std::string path = element_path.c_str();
+    template<typename T>
+    const T* Multisection::find(const path& element_path) const {
+        return find<T>(std::string_view(element_path.native()));
+    }
 
-        if (path[0] == '/') {
-            ++start;
+    template<typename T, typename S, if_string_view<S>>
+    std::optional<T> Multisection::get(const S& element_path) const {
+        if (auto element = find<T>(element_path)) {
+            return std::optional<T>(*element);
         }
+        return {};
+    }
 
-        if (path.size() > 1 && path[path.size() - 1] == '/') {
-            --end;
+    template<typename T, typename S, if_string_view<S>>
+    const T* Multisection::find(const S& element_path) const {
+        PathSegments segments{std::string_view(element_path)};
+
+        if (segments.empty()) {
+            return nullptr;
         }
 
-        return get<T>(start, end);
+        return find<T>(segments.begin(), segments.end());
+    }
+
+    template<typename T>
+    std::optional<T> Multisection::get(const SplitPath& element_path) const {
+        if (auto element = find<T>(element_path)) {
+            return std::optional<T>(*element);
+        }
+        return {};
     }
 
     template<typename T>
-    std::optional<T> Multisection::get(path::iterator current, path::iterator end) const {
-        auto next_element = m_sections.find(current->c_str());
+    const T* Multisection::find(const SplitPath& element_path) const {
+        return find<T>(element_path.begin(), element_path.end());
+    }
+
+    template<typename T, typename Iterator>
+    const T* Multisection::find(Iterator current, Iterator end) const {
+        auto next_element = section(*current);
         ++current;
 
-        if (next_element == m_sections.cend()) {
-            return {};
+        if (!next_element) {
+            return nullptr;
         }
 
         if (current == end) {
             if constexpr (std::is_same_v<Section, std::decay_t<T>>) {
-                return std::optional<T>(next_element->second);
+                return next_element;
             }
-            return {};
+            return nullptr;
         }
 
-        return std::optional<T>(next_element->second.get<T>(current, end));
+        return next_element->template find<T>(current, end);
     }
 
 }  // namespace confusepp
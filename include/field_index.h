@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace confusepp {
+
+    template<typename Key>
+    /**
+     * @brief The FieldIndex class, sorted (key, section index) pairs of one field of a Multisection
+     *
+     * Sections are referred to by their index, so the index stays valid when the Multisection is copied or moved.
+     */
+    class FieldIndex final {
+       public:
+        using entry_type = std::pair<Key, uint32_t>;
+        using const_iterator = typename std::vector<entry_type>::const_iterator;
+
+        /**
+         * @brief The Range class, the entries which match a query, ordered by key and then by section index
+         */
+        class Range final {
+           public:
+            Range(const_iterator begin, const_iterator end);
+
+            const_iterator begin() const;
+            const_iterator end() const;
+            size_t size() const;
+            bool empty() const;
+
+           private:
+            const_iterator m_begin;
+            const_iterator m_end;
+        };
+
+        /**
+         * @brief build the index, replaces the previous entries
+         * @param entries key of every section which has the field and the index of the section, NaN keys are left
+         * out, like every comparison with NaN they match no query
+         */
+        void build(std::vector<entry_type> entries);
+        Range equal(const Key& key) const;
+        /**
+         * @brief range all entries with a key in [lower, upper)
+         */
+        Range range(const Key& lower, const Key& upper) const;
+        Range between(const Key& lower, const Key& upper) const; /**< all entries with a key in [lower, upper] */
+        Range at_least(const Key& lower) const;                  /**< all entries with a key >= lower */
+        Range at_most(const Key& upper) const;                   /**< all entries with a key <= upper */
+        size_t size() const;
+
+       private:
+        /**
+         * @brief unordered whether the key is NaN, which matches no entry, so a query with it is empty
+         */
+        static bool unordered(const Key& key);
+
+        std::vector<entry_type> m_entries;
+    };
+
+    /**
+     * @brief The HashIndex class, a hash table from the hash of a string field to the sections with that hash
+     *
+     * The entries are grouped by hash and every distinct hash gets a slot in an open addressing table, which refers to
+     * its group. Only the hashes are stored, so the candidates have to be compared with the value of the section.
+     */
+    class HashIndex final {
+       public:
+        using entry_type = FieldIndex<uint64_t>::entry_type;
+        using Range = FieldIndex<uint64_t>::Range;
+
+        /**
+         * @brief build the index, replaces the previous entries
+         * @param entries hash of the field of every section which has the field and the index of the section
+         */
+        void build(std::vector<entry_type> entries);
+        /**
+         * @brief equal the entries with the hash, in the order of the sections
+         */
+        Range equal(uint64_t hash) const;
+        size_t size() const;
+
+       private:
+        /**
+         * @brief The Slot struct, the group of entries with one hash, an empty slot has begin == end
+         */
+        struct Slot {
+            uint64_t hash = 0;
+            uint32_t begin = 0;
+            uint32_t end = 0;
+        };
+
+        std::vector<entry_type> m_entries;
+        std::vector<Slot> m_slots;
+    };
+
+    template<typename Key>
+    FieldIndex<Key>::Range::Range(const_iterator begin, const_iterator end) : m_begin(begin), m_end(end) {}
+
+    template<typename Key>
+    typename FieldIndex<Key>::const_iterator FieldIndex<Key>::Range::begin() const {
+        return m_begin;
+    }
+
+    template<typename Key>
+    typename FieldIndex<Key>::const_iterator FieldIndex<Key>::Range::end() const {
+        return m_end;
+    }
+
+    template<typename Key>
+    size_t FieldIndex<Key>::Range::size() const {
+        return m_end - m_begin;
+    }
+
+    template<typename Key>
+    bool FieldIndex<Key>::Range::empty() const {
+        return m_begin == m_end;
+    }
+
+    template<typename Key>
+    void FieldIndex<Key>::build(std::vector<entry_type> entries) {
+        // NaN isn't ordered, std::sort requires a strict weak ordering of all keys
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const entry_type& entry) { return unordered(entry.first); }),
+                      entries.end());
+
+        std::sort(entries.begin(), entries.end());
+        m_entries = std::move(entries);
+    }
+
+    template<typename Key>
+    typename FieldIndex<Key>::Range FieldIndex<Key>::equal(const Key& key) const {
+        if (unordered(key)) {
+            return Range(m_entries.cend(), m_entries.cend());
+        }
+
+        auto first = std::lower_bound(m_entries.cbegin(), m_entries.cend(), key,
+                                      [](const entry_type& entry, const Key& key) { return entry.first < key; });
+        auto last = std::upper_bound(first, m_entries.cend(), key,
+                                     [](const Key& key, const entry_type& entry) { return key < entry.first; });
+
+        return Range(first, last);
+    }
+
+    template<typename Key>
+    typename FieldIndex<Key>::Range FieldIndex<Key>::range(const Key& lower, const Key& upper) const {
+        if (unordered(lower) || unordered(upper)) {
+            return Range(m_entries.cend(), m_entries.cend());
+        }
+
+        auto by_key = [](const entry_type& entry, const Key& key) { return entry.first < key; };
+        auto first = std::lower_bound(m_entries.cbegin(), m_entries.cend(), lower, by_key);
+        auto last = std::lower_bound(first, m_entries.cend(), upper, by_key);
+
+        return Range(first, last);
+    }
+
+    template<typename Key>
+    typename FieldIndex<Key>::Range FieldIndex<Key>::between(const Key& lower, const Key& upper) const {
+        auto first = at_least(lower).begin();
+        auto last = at_most(upper).end();
+
+        return Range(first, std::max(first, last));
+    }
+
+    template<typename Key>
+    typename FieldIndex<Key>::Range FieldIndex<Key>::at_least(const Key& lower) const {
+        if (unordered(lower)) {
+            return Range(m_entries.cend(), m_entries.cend());
+        }
+
+        auto first = std::lower_bound(m_entries.cbegin(), m_entries.cend(), lower,
+                                      [](const entry_type& entry, const Key& key) { return entry.first < key; });
+
+        return Range(first, m_entries.cend());
+    }
+
+    template<typename Key>
+    typename FieldIndex<Key>::Range FieldIndex<Key>::at_most(const Key& upper) const {
+        if (unordered(upper)) {
+            return Range(m_entries.cend(), m_entries.cend());
+        }
+
+        auto last = std::upper_bound(m_entries.cbegin(), m_entries.cend(), upper,
+                                     [](const Key& key, const entry_type& entry) { return key < entry.first; });
+
+        return Range(m_entries.cbegin(), last);
+    }
+
+    template<typename Key>
+    size_t FieldIndex<Key>::size() const {
+        return m_entries.size();
+    }
+
+    template<typename Key>
+    bool FieldIndex<Key>::unordered(const Key& key) {
+        if constexpr (std::is_floating_point_v<Key>) {
+            return std::isnan(key);
+        } else {
+            return false;
+        }
+    }
+
+    inline void HashIndex::build(std::vector<entry_type> entries) {
+        std::sort(entries.begin(), entries.end());
+        m_entries = std::move(entries);
+        m_slots.clear();
+
+        size_t number_of_hashes = 0;
+        for (size_t index = 0; index < m_entries.size(); ++index) {
+            number_of_hashes += index == 0 || m_entries[index].first != m_entries[index - 1].first;
+        }
+
+        // Keep the load factor at most 1/2, so probe sequences stay short
+        size_t number_of_slots = 16;
+        while (number_of_slots < number_of_hashes * 2) {
+            number_of_slots *= 2;
+        }
+
+        m_slots.resize(number_of_slots);
+        size_t mask = number_of_slots - 1;
+
+        for (size_t begin = 0, end = 0; begin < m_entries.size(); begin = end) {
+            uint64_t hash = m_entries[begin].first;
+
+            while (end < m_entries.size() && m_entries[end].first == hash) {
+                ++end;
+            }
+
+            size_t slot = hash & mask;
+            while (m_slots[slot].begin != m_slots[slot].end) {
+                slot = (slot + 1) & mask;
+            }
+
+            m_slots[slot] = {hash, static_cast<uint32_t>(begin), static_cast<uint32_t>(end)};
+        }
+    }
+
+    inline HashIndex::Range HashIndex::equal(uint64_t hash) const {
+        if (!m_slots.empty()) {
+            size_t mask = m_slots.size() - 1;
+
+            for (size_t slot = hash & mask; m_slots[slot].begin != m_slots[slot].end; slot = (slot + 1) & mask) {
+                if (m_slots[slot].hash == hash) {
+                    return Range(m_entries.cbegin() + m_slots[slot].begin, m_entries.cbegin() + m_slots[slot].end);
+                }
+            }
+        }
+
+        return Range(m_entries.cend(), m_entries.cend());
+    }
+
+    inline size_t HashIndex::size() const { return m_entries.size(); }
+
+}  // namespace confusepp
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "elements.h"
+
+namespace confusepp {
+
+    /**
+     * @brief The FlatTree class, a read-only snapshot of a loaded config tree in one contiguous arena
+     *
+     * All nodes live in a single array in breadth-first order, so the children of a node are an index range
+     * sorted by name. Scalars are stored inline in the nodes, strings and list elements in typed regions of the
+     * same allocation.
+     */
+    class FlatTree final {
+       public:
+        enum class NodeType : uint8_t {
+            section,
+            multisection,
+            integer,
+            floating,
+            boolean,
+            string,
+            int_list,
+            float_list,
+            bool_list,
+            string_list,
+            function
+        };
+
+        template<typename T>
+        /**
+         * @brief The Range class, a non-owning view of consecutive elements in the arena
+         */
+        class Range final {
+           public:
+            Range() = default;
+            Range(const T* begin, size_t size);
+
+            const T* begin() const;
+            const T* end() const;
+            size_t size() const;
+            bool empty() const;
+            const T& operator[](size_t index) const;
+
+           private:
+            const T* m_begin = nullptr;
+            size_t m_size = 0;
+        };
+
+        /**
+         * @brief The Node class, a section or a value in the arena
+         */
+        class Node final {
+           public:
+            std::string_view name() const;
+            NodeType type() const;
+
+           private:
+            std::string_view m_name;
+            NodeType m_type = NodeType::section;
+            uint32_t m_first = 0; /**< first child, first list element or first character of a string */
+            uint32_t m_size = 0;  /**< number of children, list elements or characters */
+            union {
+                int m_integer = 0;
+                float m_floating;
+                bool m_boolean;
+            };
+
+            friend class FlatTree;
+        };
+
+        FlatTree() = default;
+        /**
+         * @brief Copy the loaded values of the tree into a new arena
+         * @param root root-element of the config_tree
+         */
+        explicit FlatTree(const Section& root);
+        FlatTree(FlatTree&& tree);            /**< Moveconstructor */
+        FlatTree& operator=(FlatTree&& tree); /**< Moveassignment */
+
+        void swap(FlatTree& other);
+
+        /**
+         * @brief find the Node at the specified path
+         * @param element_path of the node
+         * @return Pointer into the arena or nullptr
+         */
+        const Node* find(std::string_view element_path) const;
+        const Node* find(const SplitPath& element_path) const;
+
+        template<typename T>
+        /**
+         * @brief get the value at the specified path
+         * @tparam T int, float, bool, std::string_view or a Range of one of these
+         * @param element_path of the value
+         * @return value or empty optional, if there is no such value or it has a different type
+         */
+        std::optional<T> get(std::string_view element_path) const;
+        template<typename T>
+        std::optional<T> get(const SplitPath& element_path) const;
+
+        template<typename T>
+        /**
+         * @brief value of the node
+         * @return value or empty optional, if the node has a different type
+         */
+        std::optional<T> value(const Node& node) const;
+
+        Range<Node> children(const Node& node) const;
+        const Node* root() const;
+        size_t size() const;  /**< number of nodes */
+        size_t bytes() const; /**< size of the arena */
+
+       private:
+        template<typename Iterator>
+        const Node* find(Iterator current, Iterator end) const;
+        const Node* child(const Node& parent, std::string_view name) const;
+
+        std::unique_ptr<std::byte[]> m_storage;
+        size_t m_bytes = 0;
+        const Node* m_nodes = nullptr;
+        const std::string_view* m_strings = nullptr;
+        const int* m_integers = nullptr;
+        const float* m_floats = nullptr;
+        const bool* m_booleans = nullptr;
+        const char* m_characters = nullptr;
+        size_t m_number_of_nodes = 0;
+    };
+
+    template<typename T>
+    FlatTree::Range<T>::Range(const T* begin, size_t size) : m_begin(begin), m_size(size) {}
+
+    template<typename T>
+    const T* FlatTree::Range<T>::begin() const {
+        return m_begin;
+    }
+
+    template<typename T>
+    const T* FlatTree::Range<T>::end() const {
+        return m_begin + m_size;
+    }
+
+    template<typename T>
+    size_t FlatTree::Range<T>::size() const {
+        return m_size;
+    }
+
+    template<typename T>
+    bool FlatTree::Range<T>::empty() const {
+        return m_size == 0;
+    }
+
+    template<typename T>
+    const T& FlatTree::Range<T>::operator[](size_t index) const {
+        return m_begin[index];
+    }
+
+    template<typename T>
+    std::optional<T> FlatTree::get(std::string_view element_path) const {
+        if (auto node = find(element_path)) {
+            return value<T>(*node);
+        }
+        return {};
+    }
+
+    template<typename T>
+    std::optional<T> FlatTree::get(const SplitPath& element_path) const {
+        if (auto node = find(element_path)) {
+            return value<T>(*node);
+        }
+        return {};
+    }
+
+    template<typename T>
+    std::optional<T> FlatTree::value(const Node& node) const {
+        if constexpr (std::is_same_v<T, int>) {
+            if (node.m_type == NodeType::integer) {
+                return node.m_integer;
+            }
+        } else if constexpr (std::is_same_v<T, float>) {
+            if (node.m_type == NodeType::floating) {
+                return node.m_floating;
+            }
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (node.m_type == NodeType::boolean) {
+                return node.m_boolean;
+            }
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            if (node.m_type == NodeType::string) {
+                return std::string_view(m_characters + node.m_first, node.m_size);
+            }
+        } else if constexpr (std::is_same_v<T, Range<int>>) {
+            if (node.m_type == NodeType::int_list) {
+                return Range<int>(m_integers + node.m_first, node.m_size);
+            }
+        } else if constexpr (std::is_same_v<T, Range<float>>) {
+            if (node.m_type == NodeType::float_list) {
+                return Range<float>(m_floats + node.m_first, node.m_size);
+            }
+        } else if constexpr (std::is_same_v<T, Range<bool>>) {
+            if (node.m_type == NodeType::bool_list) {
+                return Range<bool>(m_booleans + node.m_first, node.m_size);
+            }
+        } else if constexpr (std::is_same_v<T, Range<std::string_view>>) {
+            if (node.m_type == NodeType::string_list) {
+                return Range<std::string_view>(m_strings + node.m_first, node.m_size);
+            }
+        } else {
+            static_assert(!std::is_same_v<T, T>, "FlatTree can't provide values of this type");
+        }
+
+        return {};
+    }
+
+    template<typename Iterator>
+    const FlatTree::Node* FlatTree::find(Iterator current, Iterator end) const {
+        const Node* node = root();
+
+        for (; node && current != end; ++current) {
+            node = child(*node, *current);
+        }
+
+        return node;
+    }
+
+}  // namespace confusepp
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "elements.h"
+
+namespace confusepp {
+
+    template<typename Struct>
+    /**
+     * @brief The HotField class, maps the Option at a path to a member of the struct of a HotBlock
+     */
+    class HotField final {
+       public:
+        using member_type = std::variant<int Struct::*, float Struct::*, bool Struct::*>;
+
+        /**
+         * @brief HotField
+         * @param element_path path of an Option<int>, Option<float> or Option<bool> with the type of the member
+         * @param member which receives the value
+         */
+        HotField(std::string element_path, member_type member);
+
+        const std::string& element_path() const;
+        const member_type& member() const;
+
+       private:
+        std::string m_element_path;
+        member_type m_member;
+    };
+
+    /**
+     * @brief The HotBlockBase class, type erased base of all hot blocks, so a Config can refresh them on reload
+     */
+    class HotBlockBase {
+       public:
+        virtual ~HotBlockBase() = default;
+
+        /**
+         * @brief refresh copy the current values of the tree into the block
+         * @param root root-element of the loaded config_tree
+         * @return false if a field doesn't exist, the values are left unchanged and the block is invalid in that case
+         */
+        virtual bool refresh(const Section& root) = 0;
+    };
+
+    template<typename Struct>
+    /**
+     * @brief The HotBlock class, a plain struct filled with the values of a few Options, aligned to a cache line
+     *
+     * Reading a field of values() is a plain load, there is no lookup and no branch. Consequently refresh isn't
+     * synchronized with readers, Config::reload must not run while other threads read the block.
+     */
+    class HotBlock final : public HotBlockBase {
+       public:
+        static constexpr size_t cache_line_size = 64;
+
+        explicit HotBlock(std::vector<HotField<Struct>> fields);
+        virtual ~HotBlock() = default;
+
+        bool refresh(const Section& root) override;
+        const Struct& values() const;
+        /**
+         * @brief valid whether the last refresh found every field, otherwise values() are the ones of an older load
+         */
+        bool valid() const;
+
+       private:
+        std::vector<HotField<Struct>> m_fields;
+        bool m_valid = false;
+        alignas(cache_line_size) Struct m_values{};
+    };
+
+    template<typename Struct>
+    HotField<Struct>::HotField(std::string element_path, member_type member)
+        : m_element_path(std::move(element_path)), m_member(member) {}
+
+    template<typename Struct>
+    const std::string& HotField<Struct>::element_path() const {
+        return m_element_path;
+    }
+
+    template<typename Struct>
+    const typename HotField<Struct>::member_type& HotField<Struct>::member() const {
+        return m_member;
+    }
+
+    template<typename Struct>
+    HotBlock<Struct>::HotBlock(std::vector<HotField<Struct>> fields) : m_fields(std::move(fields)) {}
+
+    template<typename Struct>
+    bool HotBlock<Struct>::refresh(const Section& root) {
+        Struct values = m_values;
+
+        for (const auto& field : m_fields) {
+            bool found = std::visit(
+                [&root, &field, &values](auto member) {
+                    using value_type = std::decay_t<decltype(values.*member)>;
+
+                    if (auto option = root.find<Option<value_type>>(field.element_path())) {
+                        values.*member = option->value();
+                        return true;
+                    }
+                    return false;
+                },
+                field.member());
+
+            if (!found) {
+                m_valid = false;
+                return false;
+            }
+        }
+
+        // Every field is resolved before the block is touched, so it never holds values of two different loads
+        m_values = values;
+        m_valid = true;
+        return true;
+    }
+
+    template<typename Struct>
+    const Struct& HotBlock<Struct>::values() const {
+        return m_values;
+    }
+
+    template<typename Struct>
+    bool HotBlock<Struct>::valid() const {
+        return m_valid;
+    }
+
+}  // namespace confusepp
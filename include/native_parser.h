@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "elements.h"
+
+namespace confusepp {
+
+    /**
+     * @brief The NativeParser class, parses the confuse syntax directly into a config_tree without libconfuse
+     *
+     * Supports options, lists (= and +=), sections, titled multisections, quoted and unquoted strings and the
+     * comments of confuse. Functions, includes, environment variables and struct bindings are not supported, a
+     * config which uses them is rejected. A "${" in an unquoted or double quoted string counts as an environment
+     * variable, single quoted strings are taken verbatim like confuse does.
+     *
+     * A titled section whose title repeats is replaced by the later block at the position of the first one, like
+     * confuse does it, untitled sections which repeat are merged.
+     *
+     * With more than one thread the top-level sections are only located by a scan for the matching brace, their
+     * content is parsed in parallel afterwards. Sections with the same title are parsed by the same thread in the
+     * order of the file, so the result is the same as the one of a serial parse.
+     */
+    class NativeParser final {
+       public:
+        using section_visitor = std::function<void(const Section&)>;
+
+        /**
+         * @brief parse a config and load it into the tree
+         * @param buffer content of the config
+         * @param root freshly constructed config_tree, which receives the values
+         * @param number_of_threads which parse the top-level sections, 0 uses every core
+         * @param projection path prefixes which are loaded, see is_projected, empty loads everything
+         * @return false if the config has a syntax error or doesn't match the tree
+         */
+        static bool parse(std::string_view buffer, Section& root, size_t number_of_threads = 1,
+                          const std::vector<std::string>& projection = {});
+
+        /**
+         * @brief parse_file read a config file and load it into the tree
+         * @param config_path path of the config file
+         * @param root freshly constructed config_tree, which receives the values
+         * @param memory_map parse the file directly from a read-only memory mapping
+         * @param number_of_threads which parse the top-level sections, 0 uses every core
+         * @param projection path prefixes which are loaded, see is_projected, empty loads everything
+         * @return false if the file can't be read, has a syntax error or doesn't match the tree
+         */
+        static bool parse_file(const path& config_path, Section& root, bool memory_map = false,
+                               size_t number_of_threads = 1, const std::vector<std::string>& projection = {});
+
+        /**
+         * @brief stream parse a config, but hand every titled section of one Multisection to a visitor instead of
+         * keeping it
+         *
+         * Only one titled section exists at a time, so the memory doesn't grow with the number of sections. Sections
+         * with the same title are visited once for every block in the file, unlike parse, where the last block
+         * replaces the earlier ones.
+         * @param buffer content of the config
+         * @param root freshly constructed config_tree, which receives every other value
+         * @param multisection identifier of a top-level Multisection, which stays empty in the tree
+         * @param visitor called with every titled section, which is destroyed after the call
+         * @return false if the config has a syntax error or doesn't match the tree
+         */
+        static bool stream(std::string_view buffer, Section& root, std::string_view multisection,
+                           const section_visitor& visitor);
+
+        /**
+         * @brief stream_file stream a config file, see stream
+         *
+         * A file which isn't mapped is read in chunks and only the complete top-level statements of the part which
+         * was read are parsed, so the memory doesn't grow with the size of the file either way.
+         * @param config_path path of the config file
+         * @param memory_map read the file through a memory mapping, whose parsed pages can be dropped
+         * @return false if the file can't be read, has a syntax error or doesn't match the tree
+         */
+        static bool stream_file(const path& config_path, Section& root, std::string_view multisection,
+                                const section_visitor& visitor, bool memory_map = true);
+
+        /**
+         * @brief is_projected whether a top-level element is loaded with a projection
+         *
+         * An element is loaded if it is the first segment of one of the path prefixes, leading and repeated '/' are
+         * ignored, so a prefix inside of a top-level element selects all of it. Every other element isn't parsed and
+         * keeps its default value.
+         * @param projection path prefixes like "person" or "capital_of_states_in_germany/Bavaria"
+         * @param identifier of the top-level element
+         */
+        static bool is_projected(const std::vector<std::string>& projection, std::string_view identifier);
+
+       private:
+        enum class TokenType { end, string, equal, plus_equal, open_brace, close_brace, open_paren, comma, invalid };
+
+        /**
+         * @brief The Token struct, text points into the buffer or to unescaped if the string had escape sequences
+         */
+        struct Token {
+            TokenType type = TokenType::end;
+            std::string_view text;
+            std::string unescaped;
+        };
+
+        /**
+         * @brief The Block struct, the content of a top-level section which is parsed later
+         */
+        struct Block {
+            Section* section;           /**< the Section or nullptr if it is a titled section */
+            Multisection* multisection; /**< the Multisection of the titled section */
+            size_t section_index;       /**< index of the titled section in the Multisection */
+            std::string_view content;   /**< everything between the braces */
+            size_t next;                /**< index of the next Block of the same section or the number of blocks */
+        };
+
+        explicit NativeParser(std::string_view buffer, std::vector<Block>* blocks = nullptr);
+
+        /**
+         * @brief parse_blocks parse the blocks which were collected by a top-level parse in parallel
+         * @return false if one of the blocks has a syntax error
+         */
+        static bool parse_blocks(std::vector<Block>& blocks, const std::vector<size_t>& first_blocks,
+                                 size_t number_of_threads);
+        /**
+         * @brief read_file hand the content of a file to parse_content
+         * @param memory_map map the file instead of reading it into a string
+         */
+        static bool read_file(const path& config_path, bool memory_map,
+                              const std::function<bool(std::string_view)>& parse_content);
+        /**
+         * @brief map_file hand the content of a file to parse_content through a read-only memory mapping
+         * @param parsed receives the result of parse_content
+         * @return false if the file can't be mapped, parse_content isn't called then
+         */
+        static bool map_file(const path& config_path, const std::function<bool(std::string_view)>& parse_content,
+                             bool& parsed);
+        /**
+         * @brief streamed_multisection reset the tree for a stream
+         * @return the top-level Multisection which is streamed or nullptr if it doesn't exist
+         */
+        static Multisection* streamed_multisection(Section& root, std::string_view multisection);
+        /**
+         * @brief stream_statements parse complete top-level statements of a stream into the tree
+         */
+        static bool stream_statements(std::string_view buffer, Section& root, const Multisection& streamed,
+                                      const section_visitor& visitor);
+        /**
+         * @brief complete_statements the length of the part of the buffer, which holds only complete top-level
+         * statements, a statement counts as complete once the next one starts
+         */
+        static size_t complete_statements(std::string_view buffer);
+
+        bool parse_statements(Section& section, bool nested);
+        bool parse_values(Section::variant_type& element, bool append);
+        bool parse_section(Section::variant_type& element, const Token* title, bool top_level);
+        bool skip_block();
+        bool skip_statement();
+        bool assign(Section::variant_type& element, std::string_view value, bool append);
+        void next_token(Token& token);
+        bool read_quoted(Token& token, char quote);
+        void skip_whitespace();
+
+        static bool reset(Section& section);
+        /**
+         * @brief replace a titled section with a fresh copy of the prototype of its Multisection, the title is kept
+         */
+        static void replace(const Multisection& multisection, Section& section);
+        static void build_indexes(Section& section);
+
+        const char* m_current;
+        const char* m_end;
+        /**
+         * @brief m_blocks receives the top-level sections instead of parsing them, if it is set
+         */
+        std::vector<Block>* m_blocks;
+        /**
+         * @brief m_streamed the Multisection whose top-level sections are handed to m_visitor, if it is set
+         */
+        const Multisection* m_streamed = nullptr;
+        const section_visitor* m_visitor = nullptr;
+        /**
+         * @brief m_projection top-level elements outside of it are skipped, if it is set
+         */
+        const std::vector<std::string>* m_projection = nullptr;
+    };
+
+}  // namespace confusepp
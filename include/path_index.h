@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "elements.h"
+
+namespace confusepp {
+
+    /**
+     * @brief The PathIndex class, maps every fully qualified path of a loaded tree directly to its element
+     *
+     * Paths are stored without a leading or trailing '/', titled sections of a Multisection are included as
+     * "identifier/title".
+     */
+    class PathIndex final {
+       public:
+        PathIndex() = default;
+        /**
+         * @brief Index every element of the tree, the tree has to outlive the index
+         * @param root root-element of the config_tree
+         */
+        explicit PathIndex(const Section& root);
+
+        template<typename T>
+        /**
+         * @brief find the Element with a single hash lookup
+         * @param element_path fully qualified path of the element without leading or trailing '/'
+         * @return Pointer into the config_tree or nullptr
+         */
+        const T* find(std::string_view element_path) const;
+
+        /**
+         * @brief is_canonical check if the path can be looked up in the index
+         * @param element_path of the element
+         * @return true if the path has no leading, trailing or repeated '/'
+         */
+        static bool is_canonical(std::string_view element_path);
+
+        bool empty() const;
+        size_t size() const;                         /**< number of indexed paths */
+        size_t bytes() const;                        /**< approximate memory used by the index */
+        std::chrono::nanoseconds build_time() const; /**< time it took to build the index */
+
+       private:
+        static void collect(const Section& section, const std::string& prefix,
+                            std::vector<std::pair<std::string, ElementRef>>& paths);
+        static void collect(const Multisection& multisection, const std::string& prefix,
+                            std::vector<std::pair<std::string, ElementRef>>& paths);
+
+        std::unique_ptr<char[]> m_paths;
+        std::unordered_map<std::string_view, ElementRef> m_entries;
+        size_t m_bytes = 0;
+        std::chrono::nanoseconds m_build_time{0};
+    };
+
+    template<typename T>
+    const T* PathIndex::find(std::string_view element_path) const {
+        auto found = m_entries.find(element_path);
+
+        if (found == m_entries.cend()) {
+            return nullptr;
+        }
+
+        return found->second.template get<T>();
+    }
+
+}  // namespace confusepp
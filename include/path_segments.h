@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace confusepp {
+
+    /**
+     * @brief The PathSegments class, a non-allocating view of the '/' separated segments of a path
+     */
+    class PathSegments final {
+       public:
+        /**
+         * @brief The iterator class, yields every non-empty segment of the path
+         */
+        class iterator final {
+           public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = const std::string_view&;
+
+            constexpr iterator() = default;
+            constexpr explicit iterator(std::string_view element_path);
+
+            constexpr reference operator*() const;
+            constexpr pointer operator->() const;
+            constexpr iterator& operator++();
+            constexpr iterator operator++(int);
+            constexpr bool operator==(const iterator& other) const;
+            constexpr bool operator!=(const iterator& other) const;
+
+           private:
+            constexpr void next_segment();
+
+            std::string_view m_remaining;
+            std::string_view m_segment;
+        };
+
+        /**
+         * @brief Create the view, the path has to outlive it
+         * @param element_path of the element
+         */
+        constexpr explicit PathSegments(std::string_view element_path);
+
+        constexpr iterator begin() const;
+        constexpr iterator end() const;
+        constexpr bool empty() const;
+
+       private:
+        std::string_view m_path;
+    };
+
+    constexpr PathSegments::iterator::iterator(std::string_view element_path) : m_remaining(element_path) {
+        next_segment();
+    }
+
+    constexpr void PathSegments::iterator::next_segment() {
+        while (!m_remaining.empty() && m_remaining.front() == '/') {
+            m_remaining.remove_prefix(1);
+        }
+
+        size_t separator = m_remaining.find('/');
+
+        if (separator == std::string_view::npos) {
+            separator = m_remaining.size();
+        }
+
+        m_segment = m_remaining.substr(0, separator);
+        m_remaining.remove_prefix(separator);
+    }
+
+    constexpr PathSegments::iterator::reference PathSegments::iterator::operator*() const { return m_segment; }
+
+    constexpr PathSegments::iterator::pointer PathSegments::iterator::operator->() const { return &m_segment; }
+
+    constexpr PathSegments::iterator& PathSegments::iterator::operator++() {
+        next_segment();
+        return *this;
+    }
+
+    constexpr PathSegments::iterator PathSegments::iterator::operator++(int) {
+        iterator previous = *this;
+        next_segment();
+        return previous;
+    }
+
+    constexpr bool PathSegments::iterator::operator==(const iterator& other) const {
+        return m_segment.empty() == other.m_segment.empty() &&
+               (m_segment.empty() || m_segment.data() == other.m_segment.data());
+    }
+
+    constexpr bool PathSegments::iterator::operator!=(const iterator& other) const { return !(*this == other); }
+
+    constexpr PathSegments::PathSegments(std::string_view element_path) : m_path(element_path) {}
+
+    constexpr PathSegments::iterator PathSegments::begin() const { return iterator(m_path); }
+
+    constexpr PathSegments::iterator PathSegments::end() const { return iterator(); }
+
+    constexpr bool PathSegments::empty() const { return begin() == end(); }
+
+}  // namespace confusepp
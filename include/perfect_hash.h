@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace confusepp {
+
+    /**
+     * @brief Seeded FNV-1a hash, used to search for a seed per bucket in PerfectHash
+     */
+    inline uint64_t seeded_hash(std::string_view key, uint64_t seed) {
+        uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+
+        for (char current : key) {
+            hash ^= static_cast<unsigned char>(current);
+            hash *= 1099511628211ULL;
+        }
+
+        hash ^= hash >> 32;
+        hash *= 0xD6E8FEB86659FD93ULL;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    template<typename T>
+    /**
+     * @brief The PerfectHash class, a minimal perfect hash over a fixed set of string keys (hash and displace)
+     *
+     * Every key is assigned a bucket and every bucket a seed, which places all keys of the bucket into distinct
+     * slots. A lookup is two hashes of the key and one string comparison.
+     */
+    class PerfectHash final {
+       public:
+        static constexpr uint32_t max_seed = 1U << 20;
+
+        /**
+         * @brief build the hash for the keys, the keys have to outlive the PerfectHash
+         * @param entries unique keys and the values which belong to them
+         * @return true if a perfect hash was found, otherwise the PerfectHash stays empty
+         */
+        bool build(const std::vector<std::pair<std::string_view, T>>& entries);
+        const T* find(std::string_view key) const;
+        bool empty() const;
+        size_t size() const;
+        void clear();
+
+       private:
+        std::vector<uint32_t> m_seeds;
+        std::vector<std::pair<std::string_view, T>> m_slots;
+    };
+
+    template<typename T>
+    bool PerfectHash<T>::build(const std::vector<std::pair<std::string_view, T>>& entries) {
+        clear();
+
+        if (entries.empty()) {
+            return true;
+        }
+
+        size_t number_of_slots = entries.size();
+        std::vector<uint32_t> seeds((number_of_slots + 3) / 4, 0);
+        std::vector<std::vector<size_t>> buckets(seeds.size());
+
+        for (size_t index = 0; index < entries.size(); ++index) {
+            buckets[seeded_hash(entries[index].first, 0) % buckets.size()].push_back(index);
+        }
+
+        std::vector<size_t> bucket_order(buckets.size());
+        for (size_t index = 0; index < bucket_order.size(); ++index) {
+            bucket_order[index] = index;
+        }
+
+        // The largest buckets are placed first, while there are still many free slots
+        std::sort(bucket_order.begin(), bucket_order.end(),
+                  [&buckets](size_t lhs, size_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+        std::vector<bool> occupied(number_of_slots, false);
+        std::vector<size_t> slot_of_entry(entries.size());
+        std::vector<size_t> candidate_slots;
+
+        for (size_t bucket : bucket_order) {
+            if (buckets[bucket].empty()) {
+                break;
+            }
+
+            bool placed = false;
+
+            for (uint32_t seed = 1; seed < max_seed && !placed; ++seed) {
+                candidate_slots.clear();
+                placed = true;
+
+                for (size_t entry : buckets[bucket]) {
+                    size_t slot = seeded_hash(entries[entry].first, seed) % number_of_slots;
+
+                    if (occupied[slot] ||
+                        std::find(candidate_slots.cbegin(), candidate_slots.cend(), slot) != candidate_slots.cend()) {
+                        placed = false;
+                        break;
+                    }
+
+                    candidate_slots.push_back(slot);
+                }
+
+                if (placed) {
+                    seeds[bucket] = seed;
+
+                    for (size_t index = 0; index < candidate_slots.size(); ++index) {
+                        occupied[candidate_slots[index]] = true;
+                        slot_of_entry[buckets[bucket][index]] = candidate_slots[index];
+                    }
+                }
+            }
+
+            if (!placed) {
+                return false;
+            }
+        }
+
+        m_slots.resize(number_of_slots);
+        for (size_t index = 0; index < entries.size(); ++index) {
+            m_slots[slot_of_entry[index]] = entries[index];
+        }
+        m_seeds = std::move(seeds);
+
+        return true;
+    }
+
+    template<typename T>
+    const T* PerfectHash<T>::find(std::string_view key) const {
+        if (m_slots.empty()) {
+            return nullptr;
+        }
+
+        uint32_t seed = m_seeds[seeded_hash(key, 0) % m_seeds.size()];
+        const auto& slot = m_slots[seeded_hash(key, seed) % m_slots.size()];
+
+        if (slot.first != key) {
+            return nullptr;
+        }
+
+        return &slot.second;
+    }
+
+    template<typename T>
+    bool PerfectHash<T>::empty() const {
+        return m_slots.empty();
+    }
+
+    template<typename T>
+    size_t PerfectHash<T>::size() const {
+        return m_slots.size();
+    }
+
+    template<typename T>
+    void PerfectHash<T>::clear() {
+        m_seeds.clear();
+        m_slots.clear();
+    }
+
+}  // namespace confusepp
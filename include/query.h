@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "elements.h"
+
+namespace confusepp {
+
+    /**
+     * @brief The Query class, a path query which is compiled once and can then be run against any loaded tree
+     *
+     * A query is a path whose segments are either an identifier or title, or '*' for every child. A segment can be
+     * followed by a predicate "[field op literal]", where op is one of =, !=, <, <=, >, >= and the literal is a
+     * number, true, false or a (quoted) string. Numbers have to be finite and in the range of float, so nan and inf
+     * have to be quoted to be compared as strings. A predicate on a Multisection selects its titled sections, e.g.
+     * "person[age>40]/firstname", and uses an index of the field if the Multisection has one.
+     * Running a compiled query doesn't allocate.
+     */
+    class Query final {
+       public:
+        /**
+         * @brief compile the query into an execution plan
+         * @param query text of the query
+         * @return Compiled query or nothing if the query is malformed
+         */
+        static std::optional<Query> compile(std::string_view query);
+
+        template<typename F>
+        /**
+         * @brief for_each run the query and call the callback with every result
+         * @param root section from which the query starts
+         * @param callback is called with an ElementRef for every result
+         */
+        void for_each(const Section& root, F callback) const;
+
+        template<typename T>
+        /**
+         * @brief collect the results of type T, other results are skipped
+         * @param root section from which the query starts
+         * @param results cleared and filled with the results, reusing the vector avoids allocations
+         */
+        void collect(const Section& root, std::vector<const T*>& results) const;
+
+        const std::string& text() const;
+
+       private:
+        enum class Comparison : uint8_t { equal, not_equal, less, less_equal, greater, greater_equal };
+
+        struct Predicate {
+            std::string field;
+            Comparison comparison;
+            std::string literal;
+            uint64_t literal_hash;
+            std::optional<double> number;
+        };
+
+        struct Step {
+            std::string name;
+            bool wildcard;
+            std::optional<Predicate> predicate;
+        };
+
+        Query() = default;
+
+        template<typename F>
+        void visit(const ElementRef& current, size_t step, F& callback) const;
+        template<typename F>
+        void visit_child(const ElementRef& child, size_t step, F& callback) const;
+        template<typename F>
+        void visit_matches(const Multisection& multisection, const Predicate& predicate, size_t step,
+                           F& callback) const;
+        template<typename Key, typename F>
+        void visit_candidates(const Multisection& multisection, typename FieldIndex<Key>::Range candidates,
+                              const Predicate& predicate, size_t step, F& callback) const;
+        template<typename Key>
+        /**
+         * @brief candidates a superset of the entries of the index which satisfy the comparison
+         * @param lower largest key which is not greater than the literal
+         * @param upper smallest key which is not less than the literal
+         */
+        static typename FieldIndex<Key>::Range candidates(const FieldIndex<Key>& index, Comparison comparison,
+                                                          const Key& lower, const Key& upper);
+        static std::optional<Predicate> compile_predicate(std::string_view predicate);
+        static bool matches(const Section& section, const Predicate& predicate);
+
+        std::string m_text;
+        std::vector<Step> m_steps;
+    };
+
+    template<typename F>
+    void Query::for_each(const Section& root, F callback) const {
+        visit(ElementRef(&root), 0, callback);
+    }
+
+    template<typename T>
+    void Query::collect(const Section& root, std::vector<const T*>& results) const {
+        results.clear();
+        for_each(root, [&results](const ElementRef& result) {
+            if (auto element = result.get<T>()) {
+                results.push_back(element);
+            }
+        });
+    }
+
+    template<typename F>
+    void Query::visit(const ElementRef& current, size_t step, F& callback) const {
+        if (step == m_steps.size()) {
+            callback(current);
+            return;
+        }
+
+        const auto& current_step = m_steps[step];
+
+        if (auto section = current.get<Section>()) {
+            if (current_step.wildcard) {
+                for (const auto& [identifier, element] : section->m_values) {
+                    visit_child(ElementRef(&element), step, callback);
+                }
+            } else if (auto element = section->child(current_step.name)) {
+                visit_child(ElementRef(element), step, callback);
+            }
+        } else if (auto multisection = current.get<Multisection>()) {
+            if (current_step.wildcard) {
+                for (const auto& titled_section : multisection->m_sections) {
+                    visit_child(ElementRef(&titled_section), step, callback);
+                }
+            } else if (auto titled_section = multisection->section(current_step.name)) {
+                visit_child(ElementRef(titled_section), step, callback);
+            }
+        }
+    }
+
+    template<typename F>
+    void Query::visit_child(const ElementRef& child, size_t step, F& callback) const {
+        const auto& predicate = m_steps[step].predicate;
+
+        if (!predicate) {
+            visit(child, step + 1, callback);
+        } else if (auto multisection = child.get<Multisection>()) {
+            visit_matches(*multisection, *predicate, step, callback);
+        } else if (auto section = child.get<Section>(); section && matches(*section, *predicate)) {
+            visit(child, step + 1, callback);
+        }
+    }
+
+    template<typename F>
+    void Query::visit_matches(const Multisection& multisection, const Predicate& predicate, size_t step,
+                              F& callback) const {
+        auto index = multisection.m_indexes.find(predicate.field);
+
+        if (index != multisection.m_indexes.cend() && predicate.comparison != Comparison::not_equal) {
+            if (auto strings = std::get_if<HashIndex>(&index->second)) {
+                if (predicate.comparison == Comparison::equal) {
+                    visit_candidates<uint64_t>(multisection, strings->equal(predicate.literal_hash), predicate, step,
+                                               callback);
+                    return;
+                }
+            } else if (auto integers = std::get_if<FieldIndex<int>>(&index->second); integers && predicate.number) {
+                constexpr double min = std::numeric_limits<int>::min(), max = std::numeric_limits<int>::max();
+                int lower = std::clamp(std::floor(*predicate.number), min, max);
+                int upper = std::clamp(std::ceil(*predicate.number), min, max);
+
+                visit_candidates<int>(multisection, candidates(*integers, predicate.comparison, lower, upper),
+                                      predicate, step, callback);
+                return;
+            } else if (auto floats = std::get_if<FieldIndex<float>>(&index->second); floats && predicate.number) {
+                float literal = *predicate.number;
+                float lower = std::nextafter(literal, -std::numeric_limits<float>::infinity());
+                float upper = std::nextafter(literal, std::numeric_limits<float>::infinity());
+
+                visit_candidates<float>(multisection, candidates(*floats, predicate.comparison, lower, upper),
+                                        predicate, step, callback);
+                return;
+            }
+        }
+
+        for (const auto& section : multisection.m_sections) {
+            if (matches(section, predicate)) {
+                visit(ElementRef(&section), step + 1, callback);
+            }
+        }
+    }
+
+    template<typename Key, typename F>
+    void Query::visit_candidates(const Multisection& multisection, typename FieldIndex<Key>::Range candidates,
+                                 const Predicate& predicate, size_t step, F& callback) const {
+        // The index narrows the sections down, the predicate itself decides about every candidate
+        for (const auto& [key, section_index] : candidates) {
+            const auto& section = multisection.m_sections[section_index];
+
+            if (matches(section, predicate)) {
+                visit(ElementRef(&section), step + 1, callback);
+            }
+        }
+    }
+
+    template<typename Key>
+    typename FieldIndex<Key>::Range Query::candidates(const FieldIndex<Key>& index, Comparison comparison,
+                                                      const Key& lower, const Key& upper) {
+        switch (comparison) {
+            case Comparison::less:
+            case Comparison::less_equal:
+                return index.at_most(upper);
+            case Comparison::greater:
+            case Comparison::greater_equal:
+                return index.at_least(lower);
+            default:
+                return index.between(lower, upper);
+        }
+    }
+
+}  // namespace confusepp
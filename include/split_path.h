@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+#include "path_segments.h"
+
+namespace confusepp {
+
+    /**
+     * @brief The SplitPath class, a path to an element which is split into its segments at compile time
+     *
+     * Only the syntax of the path is checked, whether the element exists is only known once the path is resolved
+     * against a loaded tree, which returns nullptr or an empty optional for a path which isn't in the schema.
+     */
+    class SplitPath final {
+       public:
+        static constexpr size_t max_segments = 16;
+
+        /**
+         * @brief Split the path into its segments, a leading or trailing '/' and empty segments are ignored
+         * @param element_path of the element, has to outlive the SplitPath
+         * @throw std::invalid_argument if the path has no segments or contains "." or ".." segments
+         * @throw std::length_error if the path has more than max_segments segments
+         */
+        constexpr explicit SplitPath(std::string_view element_path);
+
+        constexpr size_t size() const;
+        constexpr const std::string_view* begin() const;
+        constexpr const std::string_view* end() const;
+        constexpr std::string_view operator[](size_t index) const;
+
+       private:
+        std::array<std::string_view, max_segments> m_segments{};
+        size_t m_size = 0;
+    };
+
+    inline namespace literals {
+        /**
+         * @brief Create a SplitPath, declare the result constexpr to reject malformed paths at compile time, the
+         * path isn't checked against a schema
+         */
+        constexpr SplitPath operator""_path(const char* element_path, size_t length) {
+            return SplitPath(std::string_view(element_path, length));
+        }
+    }  // namespace literals
+
+    constexpr SplitPath::SplitPath(std::string_view element_path) {
+        for (std::string_view segment : PathSegments(element_path)) {
+            if (segment == "." || segment == "..") {
+                throw std::invalid_argument("relative segments are not allowed in a SplitPath");
+            }
+
+            if (m_size == max_segments) {
+                throw std::length_error("too many segments in a SplitPath");
+            }
+
+            m_segments[m_size++] = segment;
+        }
+
+        if (m_size == 0) {
+            throw std::invalid_argument("a SplitPath needs at least one segment");
+        }
+    }
+
+    constexpr size_t SplitPath::size() const { return m_size; }
+
+    constexpr const std::string_view* SplitPath::begin() const { return m_segments.data(); }
+
+    constexpr const std::string_view* SplitPath::end() const { return m_segments.data() + m_size; }
+
+    constexpr std::string_view SplitPath::operator[](size_t index) const { return m_segments[index]; }
+
+}  // namespace confusepp
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <confuse.h>
+
+#include "confuse_parse.h"
+#include "elements.h"
+
+namespace confusepp {
+
+    template<typename Tag, typename... Children>
+    /**
+     * @brief static_index_of position of the child with the tag
+     * @return index of the child or sizeof...(Children) if there is no such child
+     */
+    constexpr size_t static_index_of() {
+        constexpr bool matches[] = {false, std::is_same_v<Tag, typename Children::tag_type>...};
+
+        for (size_t index = 0; index < sizeof...(Children); ++index) {
+            if (matches[index + 1]) {
+                return index;
+            }
+        }
+
+        return sizeof...(Children);
+    }
+
+    template<typename Tag, typename T>
+    /**
+     * @brief The StaticOption class, an Option whose type and tag are part of the schema type
+     * @tparam Tag any type, which names the option in get<Tag>() and value<Tag>()
+     * @tparam T int, float, bool or std::string
+     */
+    class StaticOption final {
+       public:
+        static_assert(std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, bool> ||
+                          std::is_same_v<T, std::string>,
+                      "StaticOption supports int, float, bool and std::string");
+
+        using tag_type = Tag;
+        using value_type = T;
+
+        explicit StaticOption(const char* identifier);
+
+        StaticOption& default_value(T value);
+        const char* identifier() const;
+        const T& value() const;
+
+       private:
+        cfg_opt_t confuse_representation() const;
+        void load(cfg_t* parent_handle);
+
+        const char* m_identifier;
+        T m_value{};
+        bool m_has_default_value = false;
+
+        template<typename, typename...>
+        friend class StaticSection;
+    };
+
+    template<typename Tag, typename... Children>
+    /**
+     * @brief The StaticSection class, a Section whose children are part of the type
+     *
+     * Children are stored in a tuple, loading them is a direct call for every child and get<Tag>() is resolved at
+     * compile time.
+     */
+    class StaticSection final {
+       public:
+        using tag_type = Tag;
+
+        StaticSection(const char* identifier, Children... children);
+
+        template<typename ChildTag>
+        /**
+         * @brief get the child with the tag, doesn't compile if there is no such child
+         */
+        const auto& get() const;
+        template<typename ChildTag>
+        /**
+         * @brief value of the StaticOption with the tag
+         */
+        const auto& value() const;
+        const char* identifier() const;
+        const std::string& title() const;
+
+       private:
+        /**
+         * @brief options fill the confuse representation of the children, which refers to this section
+         * @return Array of the options terminated by CFG_END()
+         */
+        cfg_opt_t* options();
+        cfg_opt_t confuse_representation(cfg_flag_t flags = CFGF_NONE);
+        void load(cfg_t* parent_handle);
+        void load_values(cfg_t* section_handle);
+
+        const char* m_identifier;
+        std::string m_title;
+        std::tuple<Children...> m_children;
+        std::array<cfg_opt_t, sizeof...(Children) + 1> m_options{};
+
+        template<typename, typename...>
+        friend class StaticSection;
+        template<typename, typename...>
+        friend class StaticMultisection;
+        template<typename...>
+        friend class StaticFormat;
+    };
+
+    template<typename Tag, typename... Children>
+    /**
+     * @brief The StaticMultisection class, a Multisection whose children are part of the type
+     */
+    class StaticMultisection final {
+       public:
+        using tag_type = Tag;
+        using section_type = StaticSection<Tag, Children...>;
+
+        StaticMultisection(const char* identifier, Children... children);
+
+        const std::vector<section_type>& sections() const; /**< titled sections in the order of the config file */
+        /**
+         * @brief section find the titled section
+         * @param title of the section
+         * @return Pointer to the section or nullptr
+         */
+        const section_type* section(std::string_view title) const;
+        const char* identifier() const;
+
+       private:
+        cfg_opt_t confuse_representation();
+        void load(cfg_t* parent_handle);
+
+        section_type m_prototype;
+        std::vector<section_type> m_sections;
+
+        template<typename, typename...>
+        friend class StaticSection;
+    };
+
+    template<typename... Children>
+    /**
+     * @brief The StaticFormat class, a schema whose whole shape is part of the type
+     *
+     * The loaded values are stored inside of the StaticFormat, the confuse handle is released right after loading.
+     */
+    class StaticFormat final {
+       public:
+        explicit StaticFormat(Children... children);
+
+        /**
+         * @brief parse the config file with this schema
+         * @param config_file File which provides the config
+         * @return Copy of this schema with the values of the file or nothing if the file can't be parsed
+         */
+        std::optional<StaticFormat> parse(const path& config_file) const;
+
+        template<typename ChildTag>
+        const auto& get() const;
+        template<typename ChildTag>
+        const auto& value() const;
+
+       private:
+        StaticSection<void, Children...> m_root;
+    };
+
+    template<typename Tag, typename... Children>
+    StaticSection<Tag, Children...> static_section(const char* identifier, Children... children) {
+        return StaticSection<Tag, Children...>(identifier, std::move(children)...);
+    }
+
+    template<typename Tag, typename... Children>
+    StaticMultisection<Tag, Children...> static_multisection(const char* identifier, Children... children) {
+        return StaticMultisection<Tag, Children...>(identifier, std::move(children)...);
+    }
+
+    template<typename Tag, typename T>
+    StaticOption<Tag, T>::StaticOption(const char* identifier) : m_identifier(identifier) {}
+
+    template<typename Tag, typename T>
+    StaticOption<Tag, T>& StaticOption<Tag, T>::default_value(T value) {
+        m_value = std::move(value);
+        m_has_default_value = true;
+        return *this;
+    }
+
+    template<typename Tag, typename T>
+    const char* StaticOption<Tag, T>::identifier() const {
+        return m_identifier;
+    }
+
+    template<typename Tag, typename T>
+    const T& StaticOption<Tag, T>::value() const {
+        return m_value;
+    }
+
+    template<typename Tag, typename T>
+    cfg_opt_t StaticOption<Tag, T>::confuse_representation() const {
+        auto flags = m_has_default_value ? CFGF_NONE : CFGF_NODEFAULT;
+
+        if constexpr (std::is_same_v<T, int>) {
+            return CFG_INT(m_identifier, m_value, flags);
+        } else if constexpr (std::is_same_v<T, float>) {
+            return CFG_FLOAT(m_identifier, m_value, flags);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return CFG_BOOL(m_identifier, (cfg_bool_t)m_value, flags);
+        } else {
+            return CFG_STR(m_identifier, m_value.c_str(), flags);
+        }
+    }
+
+    template<typename Tag, typename T>
+    void StaticOption<Tag, T>::load(cfg_t* parent_handle) {
+        if constexpr (std::is_same_v<T, int>) {
+            m_value = cfg_getint(parent_handle, m_identifier);
+        } else if constexpr (std::is_same_v<T, float>) {
+            m_value = cfg_getfloat(parent_handle, m_identifier);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            m_value = cfg_getbool(parent_handle, m_identifier);
+        } else {
+            const char* str = cfg_getstr(parent_handle, m_identifier);
+            m_value = str ? str : "";
+        }
+    }
+
+    template<typename Tag, typename... Children>
+    StaticSection<Tag, Children...>::StaticSection(const char* identifier, Children... children)
+        : m_identifier(identifier), m_children(std::move(children)...) {}
+
+    template<typename Tag, typename... Children>
+    template<typename ChildTag>
+    const auto& StaticSection<Tag, Children...>::get() const {
+        constexpr size_t index = static_index_of<ChildTag, Children...>();
+        static_assert(index < sizeof...(Children), "The section has no child with this tag");
+
+        return std::get<index>(m_children);
+    }
+
+    template<typename Tag, typename... Children>
+    template<typename ChildTag>
+    const auto& StaticSection<Tag, Children...>::value() const {
+        return get<ChildTag>().value();
+    }
+
+    template<typename Tag, typename... Children>
+    const char* StaticSection<Tag, Children...>::identifier() const {
+        return m_identifier;
+    }
+
+    template<typename Tag, typename... Children>
+    const std::string& StaticSection<Tag, Children...>::title() const {
+        return m_title;
+    }
+
+    template<typename Tag, typename... Children>
+    cfg_opt_t* StaticSection<Tag, Children...>::options() {
+        std::apply(
+            [this](auto&... children) {
+                size_t index = 0;
+                ((m_options[index++] = children.confuse_representation()), ...);
+            },
+            m_children);
+
+        m_options[sizeof...(Children)] = CFG_END();
+        return m_options.data();
+    }
+
+    template<typename Tag, typename... Children>
+    cfg_opt_t StaticSection<Tag, Children...>::confuse_representation(cfg_flag_t flags) {
+        return CFG_SEC(m_identifier, options(), flags);
+    }
+
+    template<typename Tag, typename... Children>
+    void StaticSection<Tag, Children...>::load(cfg_t* parent_handle) {
+        if (cfg_t* section_handle = cfg_getsec(parent_handle, m_identifier)) {
+            load_values(section_handle);
+        }
+    }
+
+    template<typename Tag, typename... Children>
+    void StaticSection<Tag, Children...>::load_values(cfg_t* section_handle) {
+        std::apply([section_handle](auto&... children) { (children.load(section_handle), ...); }, m_children);
+    }
+
+    template<typename Tag, typename... Children>
+    StaticMultisection<Tag, Children...>::StaticMultisection(const char* identifier, Children... children)
+        : m_prototype(identifier, std::move(children)...) {}
+
+    template<typename Tag, typename... Children>
+    const std::vector<typename StaticMultisection<Tag, Children...>::section_type>&
+    StaticMultisection<Tag, Children...>::sections() const {
+        return m_sections;
+    }
+
+    template<typename Tag, typename... Children>
+    const typename StaticMultisection<Tag, Children...>::section_type* StaticMultisection<Tag, Children...>::section(
+        std::string_view title) const {
+        for (const auto& current : m_sections) {
+            if (current.title() == title) {
+                return &current;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename Tag, typename... Children>
+    const char* StaticMultisection<Tag, Children...>::identifier() const {
+        return m_prototype.identifier();
+    }
+
+    template<typename Tag, typename... Children>
+    cfg_opt_t StaticMultisection<Tag, Children...>::confuse_representation() {
+        return m_prototype.confuse_representation(CFGF_MULTI | CFGF_TITLE);
+    }
+
+    template<typename Tag, typename... Children>
+    void StaticMultisection<Tag, Children...>::load(cfg_t* parent_handle) {
+        size_t number_of_sections = cfg_size(parent_handle, identifier());
+
+        m_sections.clear();
+        m_sections.reserve(number_of_sections);
+
+        for (size_t i = 0; i < number_of_sections; ++i) {
+            cfg_t* section_handle = cfg_getnsec(parent_handle, identifier(), i);
+            const char* section_title = cfg_title(section_handle);
+
+            auto& current = m_sections.emplace_back(m_prototype);
+            current.m_title = section_title ? section_title : "";
+            current.load_values(section_handle);
+        }
+    }
+
+    template<typename... Children>
+    StaticFormat<Children...>::StaticFormat(Children... children) : m_root("", std::move(children)...) {}
+
+    template<typename... Children>
+    std::optional<StaticFormat<Children...>> StaticFormat<Children...>::parse(const path& config_file) const {
+        StaticFormat loaded(*this);
+        cfg_t* config_handle = parse_config_file(config_file, loaded.m_root.options());
+
+        if (!config_handle) {
+            return {};
+        }
+
+        loaded.m_root.load_values(config_handle);
+        cfg_free(config_handle);
+
+        return std::optional<StaticFormat>{std::move(loaded)};
+    }
+
+    template<typename... Children>
+    template<typename ChildTag>
+    const auto& StaticFormat<Children...>::get() const {
+        return m_root.template get<ChildTag>();
+    }
+
+    template<typename... Children>
+    template<typename ChildTag>
+    const auto& StaticFormat<Children...>::value() const {
+        return m_root.template value<ChildTag>();
+    }
+
+}  // namespace confusepp
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <confuse.h>
+
+namespace confusepp {
+
+    template<typename Struct>
+    /**
+     * @brief The StructFormat class, describes the options of a section by the members of a struct
+     *
+     * The type of every option is the type of its member, the default value is the value of the member in a value
+     * initialized Struct.
+     */
+    class StructFormat final {
+       public:
+        using member_type = std::variant<int Struct::*, float Struct::*, bool Struct::*, std::string Struct::*>;
+
+        /**
+         * @brief StructFormat
+         * @param fields identifier of every option and the member which receives its value
+         */
+        StructFormat(std::initializer_list<std::pair<std::string, member_type>> fields);
+
+        /**
+         * @brief title the member which receives the title of the section
+         */
+        StructFormat& title(std::string Struct::*member);
+
+        size_t size() const;
+        /**
+         * @brief add_options write the confuse representation of every field
+         * @param options array with space for size() options, which refer to this StructFormat
+         */
+        void add_options(cfg_opt_t* options) const;
+        /**
+         * @brief load the values of a section into the struct
+         * @param section_handle confuse handle of the section
+         * @param target which receives the values
+         */
+        void load(cfg_t* section_handle, Struct& target) const;
+
+       private:
+        std::vector<std::pair<std::string, member_type>> m_fields;
+        std::optional<std::string Struct::*> m_title;
+        Struct m_defaults{};
+    };
+
+    /**
+     * @brief The StructBindingBase class, type erased base of the bindings which a Section or Multisection loads
+     */
+    class StructBindingBase {
+       public:
+        virtual ~StructBindingBase() = default;
+
+        virtual size_t size() const = 0;                        /**< number of options of the binding */
+        virtual void add_options(cfg_opt_t* options) const = 0; /**< see StructFormat::add_options */
+        /**
+         * @brief load the values into the bound struct
+         * @param handle confuse handle of the Section or of the parent of the Multisection
+         */
+        virtual void load(cfg_t* handle) = 0;
+        /**
+         * @brief clone copy the loaded structs, the format is shared with the copy
+         */
+        virtual std::unique_ptr<StructBindingBase> clone() const = 0;
+    };
+
+    /**
+     * @brief The BoundStruct class, owns the binding of a Section or Multisection
+     *
+     * Every copy of the schema gets its own copy of the loaded structs, so Configs which are parsed from the same
+     * schema never write into the same struct.
+     */
+    class BoundStruct final {
+       public:
+        BoundStruct() = default;
+        explicit BoundStruct(std::unique_ptr<StructBindingBase> binding);
+        BoundStruct(const BoundStruct& other);
+        BoundStruct(BoundStruct&& other) = default;
+        ~BoundStruct() = default;
+
+        BoundStruct& operator=(const BoundStruct& other);
+        BoundStruct& operator=(BoundStruct&& other) = default;
+
+        StructBindingBase* operator->() const;
+        const StructBindingBase* get() const;
+        explicit operator bool() const;
+
+       private:
+        std::unique_ptr<StructBindingBase> m_binding;
+    };
+
+    template<typename Struct>
+    /**
+     * @brief The SectionBinding class, loads a Section into a single struct
+     */
+    class SectionBinding final : public StructBindingBase {
+       public:
+        explicit SectionBinding(StructFormat<Struct> format);
+        virtual ~SectionBinding() = default;
+
+        size_t size() const override;
+        void add_options(cfg_opt_t* options) const override;
+        void load(cfg_t* section_handle) override;
+        std::unique_ptr<StructBindingBase> clone() const override;
+        const Struct& value() const;
+
+       private:
+        std::shared_ptr<const StructFormat<Struct>> m_format;
+        Struct m_value{};
+    };
+
+    template<typename Struct>
+    /**
+     * @brief The MultisectionBinding class, loads every titled section of a Multisection into a vector of structs
+     */
+    class MultisectionBinding final : public StructBindingBase {
+       public:
+        MultisectionBinding(StructFormat<Struct> format, std::string identifier);
+        virtual ~MultisectionBinding() = default;
+
+        size_t size() const override;
+        void add_options(cfg_opt_t* options) const override;
+        void load(cfg_t* parent_handle) override;
+        std::unique_ptr<StructBindingBase> clone() const override;
+        const std::vector<Struct>& values() const;
+
+       private:
+        std::shared_ptr<const StructFormat<Struct>> m_format;
+        std::vector<Struct> m_values;
+        std::string m_identifier;
+    };
+
+    inline BoundStruct::BoundStruct(std::unique_ptr<StructBindingBase> binding) : m_binding(std::move(binding)) {}
+
+    inline BoundStruct::BoundStruct(const BoundStruct& other)
+        : m_binding(other.m_binding ? other.m_binding->clone() : nullptr) {}
+
+    inline BoundStruct& BoundStruct::operator=(const BoundStruct& other) {
+        if (this != &other) {
+            m_binding = other.m_binding ? other.m_binding->clone() : nullptr;
+        }
+
+        return *this;
+    }
+
+    inline StructBindingBase* BoundStruct::operator->() const { return m_binding.get(); }
+
+    inline const StructBindingBase* BoundStruct::get() const { return m_binding.get(); }
+
+    inline BoundStruct::operator bool() const { return static_cast<bool>(m_binding); }
+
+    template<typename Struct>
+    StructFormat<Struct>::StructFormat(std::initializer_list<std::pair<std::string, member_type>> fields)
+        : m_fields(fields) {}
+
+    template<typename Struct>
+    StructFormat<Struct>& StructFormat<Struct>::title(std::string Struct::*member) {
+        m_title = member;
+        return *this;
+    }
+
+    template<typename Struct>
+    size_t StructFormat<Struct>::size() const {
+        return m_fields.size();
+    }
+
+    template<typename Struct>
+    void StructFormat<Struct>::add_options(cfg_opt_t* options) const {
+        for (const auto& [identifier, member] : m_fields) {
+            *options++ = std::visit(
+                [this, &identifier = identifier](auto current_member) -> cfg_opt_t {
+                    using value_type = std::decay_t<decltype(m_defaults.*current_member)>;
+                    const auto& default_value = m_defaults.*current_member;
+
+                    if constexpr (std::is_same_v<value_type, int>) {
+                        return CFG_INT(identifier.c_str(), default_value, CFGF_NONE);
+                    } else if constexpr (std::is_same_v<value_type, float>) {
+                        return CFG_FLOAT(identifier.c_str(), default_value, CFGF_NONE);
+                    } else if constexpr (std::is_same_v<value_type, bool>) {
+                        return CFG_BOOL(identifier.c_str(), (cfg_bool_t)default_value, CFGF_NONE);
+                    } else {
+                        return CFG_STR(identifier.c_str(), default_value.c_str(), CFGF_NONE);
+                    }
+                },
+                member);
+        }
+    }
+
+    template<typename Struct>
+    void StructFormat<Struct>::load(cfg_t* section_handle, Struct& target) const {
+        if (m_title) {
+            const char* section_title = cfg_title(section_handle);
+            target.**m_title = section_title ? section_title : "";
+        }
+
+        for (const auto& [identifier, member] : m_fields) {
+            std::visit(
+                [section_handle, &target, &identifier = identifier](auto current_member) {
+                    using value_type = std::decay_t<decltype(target.*current_member)>;
+
+                    if constexpr (std::is_same_v<value_type, int>) {
+                        target.*current_member = cfg_getint(section_handle, identifier.c_str());
+                    } else if constexpr (std::is_same_v<value_type, float>) {
+                        target.*current_member = cfg_getfloat(section_handle, identifier.c_str());
+                    } else if constexpr (std::is_same_v<value_type, bool>) {
+                        target.*current_member = cfg_getbool(section_handle, identifier.c_str());
+                    } else {
+                        const char* str = cfg_getstr(section_handle, identifier.c_str());
+                        target.*current_member = str ? str : "";
+                    }
+                },
+                member);
+        }
+    }
+
+    template<typename Struct>
+    SectionBinding<Struct>::SectionBinding(StructFormat<Struct> format)
+        : m_format(std::make_shared<const StructFormat<Struct>>(std::move(format))) {}
+
+    template<typename Struct>
+    size_t SectionBinding<Struct>::size() const {
+        return m_format->size();
+    }
+
+    template<typename Struct>
+    void SectionBinding<Struct>::add_options(cfg_opt_t* options) const {
+        m_format->add_options(options);
+    }
+
+    template<typename Struct>
+    void SectionBinding<Struct>::load(cfg_t* section_handle) {
+        if (section_handle) {
+            m_format->load(section_handle, m_value);
+        }
+    }
+
+    template<typename Struct>
+    std::unique_ptr<StructBindingBase> SectionBinding<Struct>::clone() const {
+        return std::make_unique<SectionBinding<Struct>>(*this);
+    }
+
+    template<typename Struct>
+    const Struct& SectionBinding<Struct>::value() const {
+        return m_value;
+    }
+
+    template<typename Struct>
+    MultisectionBinding<Struct>::MultisectionBinding(StructFormat<Struct> format, std::string identifier)
+        : m_format(std::make_shared<const StructFormat<Struct>>(std::move(format))),
+          m_identifier(std::move(identifier)) {}
+
+    template<typename Struct>
+    size_t MultisectionBinding<Struct>::size() const {
+        return m_format->size();
+    }
+
+    template<typename Struct>
+    void MultisectionBinding<Struct>::add_options(cfg_opt_t* options) const {
+        m_format->add_options(options);
+    }
+
+    template<typename Struct>
+    void MultisectionBinding<Struct>::load(cfg_t* parent_handle) {
+        size_t number_of_sections = cfg_size(parent_handle, m_identifier.c_str());
+
+        m_values.clear();
+        m_values.resize(number_of_sections);
+
+        for (size_t i = 0; i < number_of_sections; ++i) {
+            m_format->load(cfg_getnsec(parent_handle, m_identifier.c_str(), i), m_values[i]);
+        }
+    }
+
+    template<typename Struct>
+    std::unique_ptr<StructBindingBase> MultisectionBinding<Struct>::clone() const {
+        return std::make_unique<MultisectionBinding<Struct>>(*this);
+    }
+
+    template<typename Struct>
+    const std::vector<Struct>& MultisectionBinding<Struct>::values() const {
+        return m_values;
+    }
+
+}  // namespace confusepp
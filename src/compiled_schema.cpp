@@ -0,0 +1,19 @@
+#include <utility>
+
+#include "compiled_schema.h"
+
+namespace confusepp {
+
+    std::shared_ptr<const CompiledSchema> CompiledSchema::compile(ConfigFormat root) {
+        return std::make_shared<const CompiledSchema>(std::move(root));
+    }
+
+    CompiledSchema::CompiledSchema(ConfigFormat root) : m_prototype(std::move(root)) {
+        m_options = m_prototype.get_confuse_representation(m_opt_storage).subopts;
+    }
+
+    const ConfigFormat& CompiledSchema::prototype() const { return m_prototype; }
+
+    cfg_opt_t* CompiledSchema::options() const { return m_options; }
+
+}  // namespace confusepp
@@ -1,37 +1,173 @@
+#include <cstring>
 #include <memory>
 
 #include "config.h"
+#include "confuse_parse.h"
+#include "native_parser.h"
 
 namespace confusepp {
 
-    std::optional<Config> Config::parse(const path& config_path, ConfigFormat root) {
-        std::unique_ptr<FILE, decltype(&std::fclose)> config_file(std::fopen(config_path.c_str(), "r"), &std::fclose);
-        auto directory = config_path;
-        directory.remove_filename();
+    namespace {
+        /**
+         * @brief pin copy a string of the option table into storage, which isn't changed by loading the tree
+         */
+        const char* pin(const char* string, std::vector<std::unique_ptr<char[]>>& storage) {
+            size_t size = std::strlen(string) + 1;
+            storage.push_back(std::make_unique<char[]>(size));
+            return static_cast<const char*>(std::memcpy(storage.back().get(), string, size));
+        }
 
-        if (config_file) {
-            Config config(std::move(root));
-            cfg_opt_t config_structure = config.m_config_tree.get_confuse_representation(config.m_opt_storage);
-            cfg_t* config_handle = cfg_init(config_structure.subopts, CFGF_NONE);
-            cfg_add_searchpath(config_handle, directory.c_str());
+        /**
+         * @brief pin_strings pin the names and string defaults of the options and all their suboptions
+         */
+        void pin_strings(cfg_opt_t* options, std::vector<std::unique_ptr<char[]>>& storage) {
+            for (cfg_opt_t* option = options; option->name; ++option) {
+                option->name = pin(option->name, storage);
 
-            if (config_handle && cfg_parse_fp(config_handle, config_file.get()) == CFG_SUCCESS) {
-                config.config_handle(config_handle);
-                return std::optional<Config>{std::move(config)};
+                if (option->type == CFGT_STR && !(option->flags & CFGF_LIST) && option->def.string) {
+                    option->def.string = pin(option->def.string, storage);
+                } else if (option->type == CFGT_SEC && option->subopts) {
+                    pin_strings(option->subopts, storage);
+                }
             }
         }
+    }  // namespace
+
+    std::optional<Config> Config::parse(const path& config_path, ConfigFormat root, ParseOptions options) {
+        Config config(std::move(root), options);
+        config.m_config_path = config_path;
+        // Built before the tree is loaded, reload needs the original defaults
+        cfg_opt_t* confuse_options = config.build_confuse_options();
+
+        if (options.native_parser) {
+            return config.parse_native(nullptr) ? std::optional<Config>{std::move(config)} : std::optional<Config>{};
+        }
+
+        if (cfg_t* config_handle = parse_config_file(config_path, confuse_options)) {
+            config.config_handle(config_handle);
+            return std::optional<Config>{std::move(config)};
+        }
 
         return std::optional<Config>{};
     }
 
-    Config::Config(ConfigFormat config_tree, cfg_t* config_handle)
-        : m_config_handle(config_handle), m_config_tree(std::move(config_tree)) {
+    std::optional<Config> Config::parse(const path& config_path, std::shared_ptr<const CompiledSchema> schema,
+                                        ParseOptions options) {
+        if (options.native_parser) {
+            Config config(schema->prototype(), options);
+            config.m_schema = std::move(schema);
+            config.m_config_path = config_path;
+            return config.parse_native(nullptr) ? std::optional<Config>{std::move(config)} : std::optional<Config>{};
+        }
+
+        cfg_t* config_handle = parse_config_file(config_path, schema->options());
+
+        if (!config_handle) {
+            return std::optional<Config>{};
+        }
+
+        // The prototype is only copied for files which could be parsed
+        Config config(schema->prototype(), options);
+        config.m_schema = std::move(schema);
+        config.m_config_path = config_path;
+        config.config_handle(config_handle);
+        return std::optional<Config>{std::move(config)};
+    }
+
+    std::optional<Config> Config::parse_buffer(std::string_view buffer, ConfigFormat root, ParseOptions options) {
+        return parse_buffer(buffer, path(), std::move(root), options);
+    }
+
+    std::optional<Config> Config::parse_buffer(std::string_view buffer, const path& include_directory,
+                                               ConfigFormat root, ParseOptions options) {
+        Config config(std::move(root), options);
+
+        // The native parser doesn't support includes, so it is only used for self-contained buffers
+        if (options.native_parser && include_directory.empty()) {
+            return config.parse_native(&buffer) ? std::optional<Config>{std::move(config)} : std::optional<Config>{};
+        }
+
+        if (cfg_t* config_handle = parse_config_buffer(buffer, config.build_confuse_options(), include_directory)) {
+            config.config_handle(config_handle);
+            return std::optional<Config>{std::move(config)};
+        }
+
+        return std::optional<Config>{};
+    }
+
+    std::optional<Config> Config::parse_buffer(std::string_view buffer, std::shared_ptr<const CompiledSchema> schema,
+                                               ParseOptions options) {
+        if (options.native_parser) {
+            Config config(schema->prototype(), options);
+            config.m_schema = std::move(schema);
+            return config.parse_native(&buffer) ? std::optional<Config>{std::move(config)} : std::optional<Config>{};
+        }
+
+        cfg_t* config_handle = parse_config_buffer(buffer, schema->options());
+
+        if (!config_handle) {
+            return std::optional<Config>{};
+        }
+
+        Config config(schema->prototype(), options);
+        config.m_schema = std::move(schema);
+        config.config_handle(config_handle);
+        return std::optional<Config>{std::move(config)};
+    }
+
+    std::optional<Config> Config::stream(const path& config_path, ConfigFormat root, std::string_view multisection,
+                                         const NativeParser::section_visitor& visitor, ParseOptions options) {
+        // The stream is parsed serially, every value is converted and every top-level element is loaded
+        if (options.parse_threads != 1 || !options.projection.empty() || options.lazy_load) {
+            return std::optional<Config>{};
+        }
+
+        Config config(std::move(root), options);
+
+        // m_config_path stays empty, reloading would keep every streamed section
+        if (!NativeParser::stream_file(config_path, config.m_config_tree, multisection, visitor, options.memory_map)) {
+            return std::optional<Config>{};
+        }
+
+        config.finish_loading();
+        return std::optional<Config>{std::move(config)};
+    }
+
+    bool Config::reload() {
+        cfg_opt_t* confuse_options = m_schema ? m_schema->options() : m_confuse_options;
+
+        // Configs which weren't parsed from a file have no options
+        if (!confuse_options || m_config_path.empty()) {
+            return false;
+        }
+
+        cfg_t* new_handle = parse_config_file(m_config_path, confuse_options);
+
+        if (!new_handle) {
+            return false;
+        }
+
+        if (m_config_handle) {
+            cfg_free(m_config_handle);
+        }
+        return config_handle(new_handle);
     }
 
+    Config::Config(ConfigFormat config_tree, ParseOptions options, cfg_t* config_handle)
+        : m_config_handle(config_handle), m_config_tree(std::move(config_tree)), m_options(options) {}
+
     Config::Config(Config&& config)
         : m_config_handle(std::move(config.m_config_handle)),
           m_config_tree(std::move(config.m_config_tree)),
-          m_opt_storage(std::move(config.m_opt_storage)) {
+          m_opt_storage(std::move(config.m_opt_storage)),
+          m_string_storage(std::move(config.m_string_storage)),
+          m_confuse_options(config.m_confuse_options),
+          m_options(config.m_options),
+          m_path_index(std::move(config.m_path_index)),
+          m_config_path(std::move(config.m_config_path)),
+          m_hot_blocks(std::move(config.m_hot_blocks)),
+          m_lazy_mutex(std::move(config.m_lazy_mutex)),
+          m_schema(std::move(config.m_schema)) {
         config.m_config_handle = nullptr;
     }
 
@@ -41,9 +177,61 @@ namespace confusepp {
         }
     }
 
-    void Config::config_handle(cfg_t *handle) {
+    cfg_opt_t* Config::build_confuse_options() {
+        m_confuse_options = m_config_tree.get_confuse_representation(m_opt_storage).subopts;
+        pin_strings(m_confuse_options, m_string_storage);
+        return m_confuse_options;
+    }
+
+    void Config::find_batch(const std::string_view* paths, size_t count, ElementRef* results) const {
+        m_config_tree.find_batch(paths, count, results);
+    }
+
+    FlatTree Config::flatten() const { return FlatTree(m_config_tree); }
+
+    const PathIndex& Config::path_index() const { return m_path_index; }
+
+    bool Config::config_handle(cfg_t *handle) {
         m_config_handle = handle;
-        m_config_tree.load(m_config_handle);
+
+        if (m_options.lazy_load && !m_lazy_mutex) {
+            m_lazy_mutex = std::make_unique<std::mutex>();
+        }
+
+        if (m_options.projection.empty()) {
+            m_config_tree.load(m_config_handle, m_lazy_mutex.get());
+        } else {
+            m_config_tree.load_projected(m_config_handle, m_options.projection, m_lazy_mutex.get());
+        }
+
+        return finish_loading();
+    }
+
+    bool Config::parse_native(const std::string_view* buffer) {
+        bool parsed = buffer ? NativeParser::parse(*buffer, m_config_tree, m_options.parse_threads,
+                                                   m_options.projection)
+                             : NativeParser::parse_file(m_config_path, m_config_tree, m_options.memory_map,
+                                                        m_options.parse_threads, m_options.projection);
+
+        if (parsed) {
+            finish_loading();
+        }
+
+        return parsed;
+    }
+
+    bool Config::finish_loading() {
+        if (m_options.build_path_index) {
+            m_path_index = PathIndex(m_config_tree);
+        }
+
+        bool refreshed = true;
+
+        for (auto& block : m_hot_blocks) {
+            refreshed = block->refresh(m_config_tree) && refreshed;
+        }
+
+        return refreshed;
     }
 
 }  // namespace confusepp
@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "confuse_parse.h"
+
+namespace confusepp {
+
+    namespace {
+        /**
+         * @brief parser_mutex serializes every use of the lexer of confuse, which keeps its state in globals
+         *
+         * cfg_init is guarded as well, because confuse runs the lexer on the defaults of lists.
+         */
+        std::mutex& parser_mutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+    }  // namespace
+
+    cfg_t* parse_config_file(const path& config_path, cfg_opt_t* options) {
+        std::unique_ptr<FILE, decltype(&std::fclose)> config_file(std::fopen(config_path.c_str(), "r"), &std::fclose);
+        auto directory = config_path;
+        directory.remove_filename();
+
+        if (!config_file) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(parser_mutex());
+        cfg_t* config_handle = cfg_init(options, CFGF_NONE);
+
+        if (!config_handle) {
+            return nullptr;
+        }
+
+        cfg_add_searchpath(config_handle, directory.c_str());
+
+        if (cfg_parse_fp(config_handle, config_file.get()) != CFG_SUCCESS) {
+            cfg_free(config_handle);
+            return nullptr;
+        }
+
+        return config_handle;
+    }
+
+    cfg_t* parse_config_buffer(std::string_view buffer, cfg_opt_t* options, const path& include_directory) {
+        // confuse expects a null terminated buffer, a string_view may end in the middle of a larger buffer
+        std::string terminated_buffer(buffer);
+
+        std::lock_guard<std::mutex> lock(parser_mutex());
+        cfg_t* config_handle = cfg_init(options, CFGF_NONE);
+
+        if (!config_handle) {
+            return nullptr;
+        }
+
+        if (!include_directory.empty()) {
+            cfg_add_searchpath(config_handle, include_directory.c_str());
+        }
+
+        if (cfg_parse_buf(config_handle, terminated_buffer.c_str()) != CFG_SUCCESS) {
+            cfg_free(config_handle);
+            return nullptr;
+        }
+
+        return config_handle;
+    }
+
+}  // namespace confusepp
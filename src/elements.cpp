@@ -1,8 +1,11 @@
+#include <algorithm>
 #include <type_traits>
+#include <utility>
 
 #include <confuse.h>
 
 #include "elements.h"
+#include "native_parser.h"
 
 namespace confusepp {
 
@@ -13,7 +16,7 @@ namespace confusepp {
     Function::Function(const std::string& identifier, cfg_func_t function)
         : Element(identifier), m_function(function) {}
 
-    void Function::load(cfg_t *) { }
+    void Function::load(cfg_t *, std::mutex*) { }
 
     cfg_opt_t Function::get_confuse_representation() const {
         cfg_opt_t ret = CFG_FUNC(identifier().c_str(), m_function);
@@ -24,16 +27,84 @@ namespace confusepp {
     Section::Section(const std::string& identifier) : Element(identifier) {}
 
     std::optional<Section::variant_type> Section::operator[](const std::string& identifier) const {
-        if (auto section = m_values.find(identifier); section != m_values.cend()) {
-            return {section->second};
+        if (auto element = child(identifier)) {
+            return {*element};
         }
         return {};
     }
 
+    const Section::variant_type* Section::child(std::string_view identifier) const {
+        if (m_child_hash && !m_child_hash->positions.empty()) {
+            if (auto position = m_child_hash->positions.find(identifier)) {
+                return &m_values[*position].second;
+            }
+            return nullptr;
+        }
+
+        auto found = std::lower_bound(m_values.cbegin(), m_values.cend(), identifier,
+                                      [](const auto& current, std::string_view key) { return current.first < key; });
+
+        if (found != m_values.cend() && found->first == identifier) {
+            return &found->second;
+        }
+        return nullptr;
+    }
+
+    Section::variant_type* Section::child(std::string_view identifier) {
+        return const_cast<variant_type*>(static_cast<const Section*>(this)->child(identifier));
+    }
+
+    ElementRef Section::child(const ElementRef& parent, std::string_view identifier) {
+        if (auto section = parent.get<Section>()) {
+            if (auto element = section->child(identifier)) {
+                return ElementRef(element);
+            }
+        } else if (auto multisection = parent.get<Multisection>()) {
+            if (auto section = multisection->section(identifier)) {
+                return ElementRef(section);
+            }
+        }
+
+        return ElementRef();
+    }
+
+    void Section::find_batch(const std::string_view* paths, size_t count, ElementRef* results) const {
+        std::vector<size_t> order(count);
+        for (size_t index = 0; index < count; ++index) {
+            order[index] = index;
+        }
+
+        // Sorted paths share their prefix with the previous path, so only the rest has to be resolved
+        std::sort(order.begin(), order.end(), [paths](size_t lhs, size_t rhs) { return paths[lhs] < paths[rhs]; });
+
+        std::vector<std::pair<std::string_view, ElementRef>> resolved;
+
+        for (size_t index : order) {
+            PathSegments segments(paths[index]);
+            auto current = segments.begin();
+            size_t depth = 0;
+
+            while (current != segments.end() && depth < resolved.size() && resolved[depth].first == *current) {
+                ++current;
+                ++depth;
+            }
+
+            resolved.resize(depth);
+
+            for (; current != segments.end(); ++current) {
+                ElementRef parent = resolved.empty() ? ElementRef(this) : resolved.back().second;
+                resolved.emplace_back(*current, parent ? child(parent, *current) : ElementRef());
+            }
+
+            results[index] = resolved.empty() ? ElementRef() : resolved.back().second;
+        }
+    }
+
     cfg_opt_t Section::get_confuse_representation(option_storage& opt_storage) const {
         using namespace std::string_literals;
 
-        opt_storage.emplace_back(std::make_unique<cfg_opt_t[]>(m_values.size() + 1));
+        size_t number_of_options = m_values.size() + (m_binding ? m_binding->size() : 0);
+        opt_storage.emplace_back(std::make_unique<cfg_opt_t[]>(number_of_options + 1));
         size_t storage_entry = opt_storage.size() - 1;
         size_t index = 0;
 
@@ -56,6 +127,11 @@ namespace confusepp {
             ++index;
         }
 
+        if (m_binding) {
+            m_binding->add_options(&opt_storage[storage_entry][index]);
+            index += m_binding->size();
+        }
+
         opt_storage[storage_entry][index] = CFG_END();
 
         auto flags = CFGF_NONE;
@@ -80,13 +156,22 @@ namespace confusepp {
             std::visit(
                 [this](auto& argument) {
                     auto created_value(std::move(argument));
-                    m_values.emplace(argument.identifier(), created_value);
+                    auto position = std::lower_bound(
+                        m_values.begin(), m_values.end(), created_value.identifier(),
+                        [](const auto& current, const std::string& key) { return identifier_of(current) < key; });
+
+                    // The first child with an identifier wins, like it did when the children were kept in a map
+                    if (position == m_values.end() || identifier_of(*position) != created_value.identifier()) {
+                        m_values.emplace(position, std::string_view(), std::move(created_value));
+                    }
                 },
                 current_value);
         }
+
+        build_child_hash();
     }
 
-    void Section::load(cfg_t* parent_handle) {
+    void Section::load(cfg_t* parent_handle, std::mutex* lazy) {
         using namespace std::string_literals;
 
         if (!parent_handle) {
@@ -101,47 +186,143 @@ namespace confusepp {
             current_handle = cfg_gettsec(parent_handle, identifier().c_str(), title().c_str());
         }
 
+        load_values(current_handle, lazy);
+    }
+
+    void Section::load_values(cfg_t* section_handle, std::mutex* lazy) {
         for (auto& current : m_values) {
-            std::visit([&current_handle](auto& argument) { argument.load(current_handle); }, current.second);
+            std::visit([section_handle, lazy](auto& argument) { argument.load(section_handle, lazy); }, current.second);
+        }
+
+        if (m_binding) {
+            m_binding->load(section_handle);
         }
     }
 
-    ConfigFormat::ConfigFormat(const std::initializer_list<variant_type>& value_list) : Section("") {
-        values(value_list);
+    void Section::load_projected(cfg_t* section_handle, const std::vector<std::string>& projection,
+                                 std::mutex* lazy) {
+        for (auto& [identifier, current] : m_values) {
+            if (NativeParser::is_projected(projection, identifier)) {
+                std::visit([section_handle, lazy](auto& argument) { argument.load(section_handle, lazy); }, current);
+            }
+        }
+
+        // The options of a binding aren't elements of the tree, so the bound struct is always loaded completely
+        if (m_binding) {
+            m_binding->load(section_handle);
+        }
     }
 
-    void ConfigFormat::load(cfg_t* parent_handle) {
-        for (auto& current : m_values) {
-            std::visit([&parent_handle](auto& argument) { argument.load(parent_handle); }, current.second);
+    const std::string& Section::identifier_of(const std::pair<std::string_view, variant_type>& child) {
+        return std::visit([](const auto& current) -> const std::string& { return current.identifier(); },
+                          child.second);
+    }
+
+    void Section::build_child_hash() {
+        if (m_values.empty()) {
+            m_child_hash = nullptr;
+            return;
+        }
+
+        auto child_hash = std::make_shared<ChildHash>();
+        child_hash->identifiers.reserve(m_values.size());
+
+        for (const auto& current : m_values) {
+            child_hash->identifiers.push_back(identifier_of(current));
+        }
+
+        std::vector<std::pair<std::string_view, uint32_t>> positions;
+        positions.reserve(m_values.size());
+
+        for (uint32_t position = 0; position < child_hash->identifiers.size(); ++position) {
+            positions.emplace_back(child_hash->identifiers[position], position);
+            m_values[position].first = child_hash->identifiers[position];
         }
+
+        // Without a perfect hash the positions stay empty and the sorted children are searched
+        child_hash->positions.build(positions);
+        m_child_hash = std::move(child_hash);
+    }
+
+    ElementRef::ElementRef(const Section::variant_type* element) : m_element(element) {}
+
+    ElementRef::ElementRef(const Section* section) : m_section(section) {}
+
+    const Section::variant_type* ElementRef::element() const { return m_element; }
+
+    ElementRef::operator bool() const { return m_element || m_section; }
+
+    ConfigFormat::ConfigFormat(const std::initializer_list<variant_type>& value_list) : Section("") {
+        values(value_list);
     }
 
-    Multisection::Multisection(const std::string& identifier) : Element(identifier) {}
+    void ConfigFormat::load(cfg_t* parent_handle, std::mutex* lazy) { load_values(parent_handle, lazy); }
+
+    Multisection::Multisection(const std::string& identifier) : Element(identifier), m_prototype(identifier) {}
 
     std::optional<Section> Multisection::operator[](const std::string& title) const {
-        if (auto section = m_sections.find(title); section != m_sections.cend()) {
-            return {section->second};
+        if (auto found = section(title)) {
+            return {*found};
         }
         return {};
     }
 
-    std::vector<Section> Multisection::sections() const {
-        std::vector<Section> ret;
-        ret.reserve(m_sections.size());
+    const Section* Multisection::section(std::string_view title) const {
+        if (size_t index = find_title(title); index != m_sections.size()) {
+            return &m_sections[index];
+        }
+        return nullptr;
+    }
 
-        for (auto it : m_sections) {
-            ret.emplace_back(it.second);
+    size_t Multisection::find_title(std::string_view title) const {
+        if (m_title_slots.empty()) {
+            return m_sections.size();
         }
 
-        return ret;
+        size_t mask = m_title_slots.size() - 1;
+
+        for (size_t slot = std::hash<std::string_view>{}(title) & mask; m_title_slots[slot]; slot = (slot + 1) & mask) {
+            if (m_sections[m_title_slots[slot] - 1].title() == title) {
+                return m_title_slots[slot] - 1;
+            }
+        }
+
+        return m_sections.size();
+    }
+
+    const std::vector<Section>& Multisection::sections() const { return m_sections; }
+
+    void Multisection::index_title(uint32_t section_index) {
+        // Keep the load factor at most 1/2, so probe sequences stay short
+        if (m_sections.size() * 2 > m_title_slots.size()) {
+            m_title_slots.assign(std::max<size_t>(16, m_title_slots.size() * 2), 0);
+
+            for (uint32_t index = 0; index < section_index; ++index) {
+                place_title(index);
+            }
+        }
+
+        place_title(section_index);
+    }
+
+    void Multisection::place_title(uint32_t section_index) {
+        size_t mask = m_title_slots.size() - 1;
+        size_t slot = std::hash<std::string_view>{}(m_sections[section_index].title()) & mask;
+
+        while (m_title_slots[slot]) {
+            slot = (slot + 1) & mask;
+        }
+
+        m_title_slots[slot] = section_index + 1;
     }
 
     cfg_opt_t Multisection::get_confuse_representation(option_storage& opt_storage) const {
-        opt_storage.emplace_back(std::make_unique<cfg_opt_t[]>(m_values.size() + 1));
+        size_t number_of_options = m_prototype.m_values.size() + (m_binding ? m_binding->size() : 0);
+        opt_storage.emplace_back(std::make_unique<cfg_opt_t[]>(number_of_options + 1));
         size_t storage_entry = opt_storage.size() - 1;
         size_t index = 0;
 
-        for (const auto& current_value : m_values) {
+        for (const auto& current_value : m_prototype.m_values) {
             cfg_opt_t opt_definition;
 
             std::visit(
@@ -155,29 +336,89 @@ namespace confusepp {
                         opt_definition = argument.get_confuse_representation();
                     }
                 },
-                current_value);
+                current_value.second);
 
             opt_storage[storage_entry][index] = opt_definition;
             ++index;
         }
 
+        if (m_binding) {
+            m_binding->add_options(&opt_storage[storage_entry][index]);
+            index += m_binding->size();
+        }
+
         opt_storage[storage_entry][index] = CFG_END();
 
         cfg_opt_t ret = CFG_SEC(identifier().c_str(), opt_storage[storage_entry].get(), CFGF_MULTI | CFGF_TITLE);
         return ret;
     }
 
-    void Multisection::load(cfg_t* parent_handle) {
+    void Multisection::load(cfg_t* parent_handle, std::mutex* lazy) {
         size_t number_of_sections = cfg_size(parent_handle, identifier().c_str());
+        m_columns.clear();
+        // A reload replaces all titled sections, sections which were removed from the file must not survive
+        m_sections.clear();
+        m_title_slots.clear();
+
+        // Bound sections are loaded straight into the structs, without building a Section for every title
+        if (m_binding) {
+            m_binding->load(parent_handle);
+            build_indexes();
+            return;
+        }
+
+        m_sections.reserve(number_of_sections);
 
         for (size_t i = 0; i < number_of_sections; i++) {
             cfg_t* sub_section_handle = cfg_getnsec(parent_handle, identifier().c_str(), i);
             const char* sub_section_title = sub_section_handle->title;
 
-            auto created_section = m_sections.emplace(
-                std::make_pair(sub_section_title, Section(identifier()).title(sub_section_title).values(m_values)));
+            size_t section_index = find_title(sub_section_title);
+
+            if (section_index == m_sections.size()) {
+                m_sections.emplace_back(m_prototype).title(sub_section_title);
+                index_title(section_index);
+            }
+
+            // Loading from the handle directly, looking it up by title again would be linear in the number of titles
+            m_sections[section_index].load_values(sub_section_handle, lazy);
+        }
+
+        build_indexes();
+    }
+
+    Multisection& Multisection::index_on(const std::string& field) {
+        m_indexes.emplace(field, std::monostate{});
+        return *this;
+    }
 
-            created_section.first->second.load(parent_handle);
+    void Multisection::build_indexes() {
+        for (auto& [field, index] : m_indexes) {
+            std::vector<HashIndex::entry_type> strings;
+            std::vector<FieldIndex<int>::entry_type> integers;
+            std::vector<FieldIndex<float>::entry_type> floats;
+
+            for (uint32_t section_index = 0; section_index < m_sections.size(); ++section_index) {
+                const auto& section = m_sections[section_index];
+
+                if (auto option = section.find<Option<std::string>>(field)) {
+                    strings.emplace_back(seeded_hash(option->value(), 0), section_index);
+                } else if (auto option = section.find<Option<int>>(field)) {
+                    integers.emplace_back(option->value(), section_index);
+                } else if (auto option = section.find<Option<float>>(field)) {
+                    floats.emplace_back(option->value(), section_index);
+                }
+            }
+
+            // The field has the same type in every section, an empty index is only kept for unsupported types
+            index = std::monostate{};
+            if (!strings.empty()) {
+                index.emplace<HashIndex>().build(std::move(strings));
+            } else if (!integers.empty()) {
+                index.emplace<FieldIndex<int>>().build(std::move(integers));
+            } else if (!floats.empty()) {
+                index.emplace<FieldIndex<float>>().build(std::move(floats));
+            }
         }
     }
 }  // namespace confusepp
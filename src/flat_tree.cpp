@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "flat_tree.h"
+
+namespace confusepp {
+
+    namespace {
+        /**
+         * @brief Element of the tree which still has to be copied into the arena
+         */
+        struct PendingNode {
+            std::string_view name;
+            const Section* section = nullptr;
+            const Section::variant_type* element = nullptr;
+            uint32_t first_child = 0;
+            uint32_t number_of_children = 0;
+        };
+
+        size_t align_to(size_t offset, size_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+        template<typename T>
+        size_t list_size(const Section::variant_type& element) {
+            if (auto option = std::get_if<Option<List<T>>>(&element)) {
+                return option->value().size();
+            }
+            return 0;
+        }
+
+        size_t string_size(const Section::variant_type& element) {
+            size_t size = 0;
+
+            if (auto option = std::get_if<Option<std::string>>(&element)) {
+                size = option->value().size();
+            } else if (auto list = std::get_if<Option<List<std::string>>>(&element)) {
+                for (const auto& current : list->value()) {
+                    size += current.size();
+                }
+            }
+
+            return size;
+        }
+    }  // namespace
+
+    std::string_view FlatTree::Node::name() const { return m_name; }
+
+    FlatTree::NodeType FlatTree::Node::type() const { return m_type; }
+
+    FlatTree::FlatTree(const Section& root) {
+        std::vector<PendingNode> pending{PendingNode{"", &root, nullptr}};
+
+        // Breadth-first, so the children of every node end up next to each other
+        for (size_t index = 0; index < pending.size(); ++index) {
+            uint32_t first_child = pending.size();
+
+            if (auto section = pending[index].section) {
+                for (const auto& [identifier, element] : section->m_values) {
+                    pending.push_back(PendingNode{identifier, std::get_if<Section>(&element), &element});
+                }
+            } else if (auto multisection = std::get_if<Multisection>(pending[index].element)) {
+                size_t first_section = pending.size();
+
+                for (const auto& section : multisection->m_sections) {
+                    pending.push_back(PendingNode{section.title(), &section, nullptr});
+                }
+
+                // Titles are stored in file order, but children are looked up with a binary search
+                std::sort(pending.begin() + first_section, pending.end(),
+                          [](const PendingNode& lhs, const PendingNode& rhs) { return lhs.name < rhs.name; });
+            }
+
+            pending[index].first_child = first_child;
+            pending[index].number_of_children = pending.size() - first_child;
+        }
+
+        size_t number_of_strings = 0, number_of_integers = 0, number_of_floats = 0, number_of_booleans = 0,
+               number_of_characters = 0;
+
+        for (const auto& current : pending) {
+            number_of_characters += current.name.size();
+
+            if (current.element) {
+                number_of_strings += list_size<std::string>(*current.element);
+                number_of_integers += list_size<int>(*current.element);
+                number_of_floats += list_size<float>(*current.element);
+                number_of_booleans += list_size<bool>(*current.element);
+                number_of_characters += string_size(*current.element);
+            }
+        }
+
+        size_t strings_offset = align_to(pending.size() * sizeof(Node), alignof(std::string_view));
+        size_t integers_offset = align_to(strings_offset + number_of_strings * sizeof(std::string_view), alignof(int));
+        size_t floats_offset = align_to(integers_offset + number_of_integers * sizeof(int), alignof(float));
+        size_t booleans_offset = align_to(floats_offset + number_of_floats * sizeof(float), alignof(bool));
+        size_t characters_offset = booleans_offset + number_of_booleans * sizeof(bool);
+
+        m_bytes = characters_offset + number_of_characters;
+        m_storage.reset(new std::byte[m_bytes]);
+        m_number_of_nodes = pending.size();
+
+        auto nodes = reinterpret_cast<Node*>(m_storage.get());
+        auto strings = reinterpret_cast<std::string_view*>(m_storage.get() + strings_offset);
+        auto integers = reinterpret_cast<int*>(m_storage.get() + integers_offset);
+        auto floats = reinterpret_cast<float*>(m_storage.get() + floats_offset);
+        auto booleans = reinterpret_cast<bool*>(m_storage.get() + booleans_offset);
+        auto characters = reinterpret_cast<char*>(m_storage.get() + characters_offset);
+
+        m_nodes = nodes;
+        m_strings = strings;
+        m_integers = integers;
+        m_floats = floats;
+        m_booleans = booleans;
+        m_characters = characters;
+
+        uint32_t next_string = 0, next_integer = 0, next_float = 0, next_boolean = 0, next_character = 0;
+
+        auto copy_characters = [characters, &next_character](std::string_view value) {
+            std::memcpy(characters + next_character, value.data(), value.size());
+            std::string_view copied(characters + next_character, value.size());
+            next_character += value.size();
+            return copied;
+        };
+
+        for (size_t index = 0; index < pending.size(); ++index) {
+            const auto& current = pending[index];
+            Node* node = new (nodes + index) Node();
+
+            node->m_name = copy_characters(current.name);
+
+            if (current.section) {
+                node->m_type = NodeType::section;
+                node->m_first = current.first_child;
+                node->m_size = current.number_of_children;
+                continue;
+            }
+
+            std::visit(
+                [&](const auto& element) {
+                    using current_type = std::decay_t<decltype(element)>;
+
+                    if constexpr (std::is_same_v<current_type, Multisection>) {
+                        node->m_type = NodeType::multisection;
+                        node->m_first = current.first_child;
+                        node->m_size = current.number_of_children;
+                    } else if constexpr (std::is_same_v<current_type, Option<int>>) {
+                        node->m_type = NodeType::integer;
+                        node->m_integer = element.value();
+                    } else if constexpr (std::is_same_v<current_type, Option<float>>) {
+                        node->m_type = NodeType::floating;
+                        node->m_floating = element.value();
+                    } else if constexpr (std::is_same_v<current_type, Option<bool>>) {
+                        node->m_type = NodeType::boolean;
+                        node->m_boolean = element.value();
+                    } else if constexpr (std::is_same_v<current_type, Option<std::string>>) {
+                        node->m_type = NodeType::string;
+                        node->m_first = next_character;
+                        node->m_size = element.value().size();
+                        copy_characters(element.value());
+                    } else if constexpr (std::is_same_v<current_type, Option<List<int>>>) {
+                        node->m_type = NodeType::int_list;
+                        node->m_first = next_integer;
+                        node->m_size = element.value().size();
+                        std::copy(element.value().cbegin(), element.value().cend(), integers + next_integer);
+                        next_integer += element.value().size();
+                    } else if constexpr (std::is_same_v<current_type, Option<List<float>>>) {
+                        node->m_type = NodeType::float_list;
+                        node->m_first = next_float;
+                        node->m_size = element.value().size();
+                        std::copy(element.value().cbegin(), element.value().cend(), floats + next_float);
+                        next_float += element.value().size();
+                    } else if constexpr (std::is_same_v<current_type, Option<List<bool>>>) {
+                        node->m_type = NodeType::bool_list;
+                        node->m_first = next_boolean;
+                        node->m_size = element.value().size();
+                        std::copy(element.value().cbegin(), element.value().cend(), booleans + next_boolean);
+                        next_boolean += element.value().size();
+                    } else if constexpr (std::is_same_v<current_type, Option<List<std::string>>>) {
+                        node->m_type = NodeType::string_list;
+                        node->m_first = next_string;
+                        node->m_size = element.value().size();
+                        for (const auto& value : element.value()) {
+                            new (strings + next_string++) std::string_view(copy_characters(value));
+                        }
+                    } else {
+                        node->m_type = NodeType::function;
+                    }
+                },
+                *current.element);
+        }
+    }
+
+    FlatTree::FlatTree(FlatTree&& tree) { swap(tree); }
+
+    FlatTree& FlatTree::operator=(FlatTree&& tree) {
+        FlatTree moved(std::move(tree));
+        swap(moved);
+        return *this;
+    }
+
+    void FlatTree::swap(FlatTree& other) {
+        using std::swap;
+
+        swap(m_storage, other.m_storage);
+        swap(m_bytes, other.m_bytes);
+        swap(m_nodes, other.m_nodes);
+        swap(m_strings, other.m_strings);
+        swap(m_integers, other.m_integers);
+        swap(m_floats, other.m_floats);
+        swap(m_booleans, other.m_booleans);
+        swap(m_characters, other.m_characters);
+        swap(m_number_of_nodes, other.m_number_of_nodes);
+    }
+
+    const FlatTree::Node* FlatTree::find(std::string_view element_path) const {
+        PathSegments segments(element_path);
+
+        if (segments.empty()) {
+            return nullptr;
+        }
+
+        return find(segments.begin(), segments.end());
+    }
+
+    const FlatTree::Node* FlatTree::find(const SplitPath& element_path) const {
+        return find(element_path.begin(), element_path.end());
+    }
+
+    FlatTree::Range<FlatTree::Node> FlatTree::children(const Node& node) const {
+        if (node.m_type != NodeType::section && node.m_type != NodeType::multisection) {
+            return {};
+        }
+
+        return Range<Node>(m_nodes + node.m_first, node.m_size);
+    }
+
+    const FlatTree::Node* FlatTree::root() const { return m_number_of_nodes ? m_nodes : nullptr; }
+
+    size_t FlatTree::size() const { return m_number_of_nodes; }
+
+    size_t FlatTree::bytes() const { return m_bytes; }
+
+    const FlatTree::Node* FlatTree::child(const Node& parent, std::string_view name) const {
+        auto siblings = children(parent);
+        auto found = std::lower_bound(siblings.begin(), siblings.end(), name,
+                                      [](const Node& node, std::string_view name) { return node.m_name < name; });
+
+        if (found == siblings.end() || found->m_name != name) {
+            return nullptr;
+        }
+
+        return found;
+    }
+
+}  // namespace confusepp
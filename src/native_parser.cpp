@@ -0,0 +1,989 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CONFUSEPP_HAS_MMAP 1
+#endif
+
+#include "native_parser.h"
+
+namespace confusepp {
+
+    namespace {
+        template<typename T>
+        struct is_list : std::false_type {};
+
+        template<typename T>
+        struct is_list<List<T>> : std::true_type {};
+
+        /**
+         * @brief Characters which can't be part of an unquoted string
+         */
+        constexpr std::array<bool, 256> make_delimiters() {
+            std::array<bool, 256> delimiters{};
+
+            for (unsigned char current : std::string_view(" \t\r\n\v\f\"'{}(),=#")) {
+                delimiters[current] = true;
+            }
+            delimiters[0] = true;
+
+            return delimiters;
+        }
+
+        constexpr std::array<bool, 256> delimiters = make_delimiters();
+
+        bool is_whitespace(char current) {
+            return current == ' ' || current == '\t' || current == '\n' || current == '\r' || current == '\v' ||
+                   current == '\f';
+        }
+
+        /**
+         * @brief uses_environment whether confuse would substitute an environment variable in the string
+         */
+        bool uses_environment(std::string_view text) { return text.find("${") != std::string_view::npos; }
+
+        /**
+         * @brief find_either find the first occurrence of one of two characters, compares eight bytes at a time
+         */
+        const char* find_either(const char* current, const char* end, char first, char second) {
+            constexpr uint64_t ones = 0x0101010101010101ULL, highs = 0x8080808080808080ULL;
+            const uint64_t first_pattern = ones * static_cast<unsigned char>(first);
+            const uint64_t second_pattern = ones * static_cast<unsigned char>(second);
+
+            // A word with a match always has its high bit set, the exact position is found bytewise below
+            while (end - current >= 8) {
+                uint64_t word;
+                std::memcpy(&word, current, sizeof(word));
+
+                uint64_t first_zero = word ^ first_pattern, second_zero = word ^ second_pattern;
+                if (((first_zero - ones) & ~first_zero & highs) | ((second_zero - ones) & ~second_zero & highs)) {
+                    break;
+                }
+
+                current += 8;
+            }
+
+            while (current < end && *current != first && *current != second) {
+                ++current;
+            }
+
+            return current;
+        }
+
+        bool equals_ignore_case(std::string_view text, std::string_view expected) {
+            if (text.size() != expected.size()) {
+                return false;
+            }
+
+            for (size_t index = 0; index < text.size(); ++index) {
+                if ((text[index] | 0x20) != expected[index]) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool convert(std::string_view text, int& value) {
+            bool negative = !text.empty() && text.front() == '-';
+            if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+                text.remove_prefix(1);
+            }
+
+            // Same bases as strtol with base 0, which confuse uses
+            int base = 10;
+            if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+                base = 16;
+                text.remove_prefix(2);
+            } else if (text.size() > 1 && text[0] == '0') {
+                base = 8;
+                text.remove_prefix(1);
+            }
+
+            // from_chars takes a sign of its own, the sign was stripped already, so a second one is rejected
+            long parsed = 0;
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed, base);
+
+            if (text.empty() || text.front() == '-' || error != std::errc() || end != text.data() + text.size()) {
+                return false;
+            }
+
+            value = negative ? -parsed : parsed;
+            return true;
+        }
+
+        bool convert(std::string_view text, float& value) {
+            bool positive = !text.empty() && text.front() == '+';
+            if (positive) {
+                text.remove_prefix(1);
+            }
+
+            double parsed = 0;
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+
+            if (text.empty() || (positive && text.front() == '-') || error != std::errc() ||
+                end != text.data() + text.size()) {
+                return false;
+            }
+
+            value = parsed;
+            return true;
+        }
+
+        bool convert(std::string_view text, bool& value) {
+            if (equals_ignore_case(text, "true") || equals_ignore_case(text, "yes") ||
+                equals_ignore_case(text, "on")) {
+                value = true;
+                return true;
+            }
+
+            if (equals_ignore_case(text, "false") || equals_ignore_case(text, "no") ||
+                equals_ignore_case(text, "off")) {
+                value = false;
+                return true;
+            }
+
+            return false;
+        }
+
+        bool convert(std::string_view text, std::string& value) {
+            value.assign(text);
+            return true;
+        }
+    }  // namespace
+
+    NativeParser::NativeParser(std::string_view buffer, std::vector<Block>* blocks)
+        : m_current(buffer.data()), m_end(buffer.data() + buffer.size()), m_blocks(blocks) {}
+
+    bool NativeParser::parse(std::string_view buffer, Section& root, size_t number_of_threads,
+                             const std::vector<std::string>& projection) {
+        if (!reset(root)) {
+            return false;
+        }
+
+        if (number_of_threads == 0) {
+            number_of_threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        std::vector<Block> blocks;
+        NativeParser parser(buffer, number_of_threads > 1 ? &blocks : nullptr);
+        parser.m_projection = projection.empty() ? nullptr : &projection;
+
+        if (!parser.parse_statements(root, false)) {
+            return false;
+        }
+
+        // Chains the blocks of the same section, so they are parsed one after another in the order of the file
+        std::map<std::pair<const void*, size_t>, size_t> last_blocks;
+        std::vector<size_t> first_blocks;
+
+        for (size_t block_index = 0; block_index < blocks.size(); ++block_index) {
+            auto& block = blocks[block_index];
+            std::pair<const void*, size_t> target(block.section, 0);
+
+            if (!block.section) {
+                target = {block.multisection, block.section_index};
+            }
+
+            block.next = blocks.size();
+            auto [last_block, inserted] = last_blocks.try_emplace(target, block_index);
+
+            if (inserted) {
+                first_blocks.push_back(block_index);
+            } else {
+                blocks[last_block->second].next = block_index;
+                last_block->second = block_index;
+            }
+        }
+
+        if (!parse_blocks(blocks, first_blocks, number_of_threads)) {
+            return false;
+        }
+
+        build_indexes(root);
+        return true;
+    }
+
+    bool NativeParser::parse_blocks(std::vector<Block>& blocks, const std::vector<size_t>& first_blocks,
+                                    size_t number_of_threads) {
+        // The titled sections don't move anymore, every block refers to a section which no other thread touches
+        for (auto& block : blocks) {
+            if (!block.section) {
+                block.section = &block.multisection->m_sections[block.section_index];
+            }
+        }
+
+        // Claiming a few chains at once keeps the contention on the counter low for many small sections
+        constexpr size_t chains_per_claim = 16;
+        std::atomic<size_t> next_chain = 0;
+        std::atomic<bool> valid = true;
+
+        auto parse_chains = [&blocks, &first_blocks, &next_chain, &valid] {
+            while (valid) {
+                size_t first_chain = next_chain.fetch_add(chains_per_claim);
+
+                if (first_chain >= first_blocks.size()) {
+                    return;
+                }
+
+                size_t last_chain = std::min(first_chain + chains_per_claim, first_blocks.size());
+
+                for (size_t chain = first_chain; chain < last_chain; ++chain) {
+                    for (size_t block_index = first_blocks[chain]; block_index < blocks.size();
+                         block_index = blocks[block_index].next) {
+                        const auto& block = blocks[block_index];
+
+                        // The later blocks of a title replace the section, the earlier ones are still checked
+                        if (block_index != first_blocks[chain] && block.multisection) {
+                            replace(*block.multisection, *block.section);
+                        }
+
+                        NativeParser parser(block.content);
+
+                        if (!parser.parse_statements(*block.section, false)) {
+                            valid = false;
+                            return;
+                        }
+                    }
+                }
+            }
+        };
+
+        size_t number_of_workers = std::min(number_of_threads, first_blocks.size() / chains_per_claim + 1);
+        std::vector<std::thread> workers;
+
+        for (size_t worker = 1; worker < number_of_workers; ++worker) {
+            workers.emplace_back(parse_chains);
+        }
+
+        parse_chains();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        return valid;
+    }
+
+    bool NativeParser::parse_file(const path& config_path, Section& root, bool memory_map, size_t number_of_threads,
+                                  const std::vector<std::string>& projection) {
+        return read_file(config_path, memory_map, [&root, number_of_threads, &projection](std::string_view content) {
+            return parse(content, root, number_of_threads, projection);
+        });
+    }
+
+    bool NativeParser::is_projected(const std::vector<std::string>& projection, std::string_view identifier) {
+        return std::any_of(projection.begin(), projection.end(), [identifier](std::string_view prefix) {
+            PathSegments segments(prefix);
+            return !segments.empty() && *segments.begin() == identifier;
+        });
+    }
+
+    bool NativeParser::stream(std::string_view buffer, Section& root, std::string_view multisection,
+                              const section_visitor& visitor) {
+        auto streamed = streamed_multisection(root, multisection);
+
+        if (!streamed || !stream_statements(buffer, root, *streamed, visitor)) {
+            return false;
+        }
+
+        build_indexes(root);
+        return true;
+    }
+
+    bool NativeParser::stream_file(const path& config_path, Section& root, std::string_view multisection,
+                                   const section_visitor& visitor, bool memory_map) {
+        bool parsed = false;
+        auto stream_content = [&root, multisection, &visitor](std::string_view content) {
+            return stream(content, root, multisection, visitor);
+        };
+
+        // Pages of the mapping, which were parsed already, can be dropped, so a big file isn't kept in memory
+        if (memory_map && map_file(config_path, stream_content, parsed)) {
+            return parsed;
+        }
+
+        std::unique_ptr<FILE, decltype(&std::fclose)> config_file(std::fopen(config_path.c_str(), "rb"), &std::fclose);
+        auto streamed = config_file ? streamed_multisection(root, multisection) : nullptr;
+
+        if (!streamed) {
+            return false;
+        }
+
+        // Without a mapping the file is read in chunks, the statement at the end of a chunk waits for the next one
+        std::string pending;
+
+        while (true) {
+            size_t size = pending.size();
+            // A statement which doesn't fit doubles the chunk, so it isn't scanned again for every small chunk
+            pending.resize(size + std::max<size_t>(1 << 16, size));
+            size_t read = std::fread(pending.data() + size, 1, pending.size() - size, config_file.get());
+            pending.resize(size + read);
+
+            if (read == 0) {
+                break;
+            }
+
+            size_t complete = complete_statements(pending);
+
+            if (!stream_statements(std::string_view(pending).substr(0, complete), root, *streamed, visitor)) {
+                return false;
+            }
+            pending.erase(0, complete);
+        }
+
+        if (std::ferror(config_file.get()) || !stream_statements(pending, root, *streamed, visitor)) {
+            return false;
+        }
+
+        build_indexes(root);
+        return true;
+    }
+
+    Multisection* NativeParser::streamed_multisection(Section& root, std::string_view multisection) {
+        auto streamed = root.child(multisection);
+
+        if (!streamed || !std::holds_alternative<Multisection>(*streamed) || !reset(root)) {
+            return nullptr;
+        }
+
+        return &std::get<Multisection>(*streamed);
+    }
+
+    bool NativeParser::stream_statements(std::string_view buffer, Section& root, const Multisection& streamed,
+                                         const section_visitor& visitor) {
+        NativeParser parser(buffer);
+        parser.m_streamed = &streamed;
+        parser.m_visitor = &visitor;
+
+        return parser.parse_statements(root, false);
+    }
+
+    size_t NativeParser::complete_statements(std::string_view buffer) {
+        NativeParser parser(buffer);
+        size_t complete = 0;
+        Token name;
+
+        // A statement is only complete once the next one starts, a value at the end of the buffer may be cut
+        for (parser.skip_whitespace(); parser.m_current < parser.m_end; parser.skip_whitespace()) {
+            complete = parser.m_current - buffer.data();
+            parser.next_token(name);
+
+            if (name.type != TokenType::string || !parser.skip_statement()) {
+                break;
+            }
+        }
+
+        return complete;
+    }
+
+    bool NativeParser::map_file(const path& config_path, const std::function<bool(std::string_view)>& parse_content,
+                                bool& parsed) {
+#ifdef CONFUSEPP_HAS_MMAP
+        int file_descriptor = open(config_path.c_str(), O_RDONLY);
+
+        if (file_descriptor < 0) {
+            return false;
+        }
+
+        struct stat file_status;
+        size_t file_size = fstat(file_descriptor, &file_status) == 0 ? file_status.st_size : 0;
+        void* mapping = file_size ? mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0) : nullptr;
+
+        // Pages behind the end of a file, which shrank since fstat, fault on access, so it is read the usual way
+        if (mapping && mapping != MAP_FAILED &&
+            (fstat(file_descriptor, &file_status) != 0 || static_cast<size_t>(file_status.st_size) != file_size)) {
+            munmap(mapping, file_size);
+            mapping = MAP_FAILED;
+        }
+        close(file_descriptor);
+
+        if (!mapping || mapping == MAP_FAILED) {
+            return false;
+        }
+
+        // The parser works on a string_view, so unlike confuse it doesn't need a terminated buffer
+        posix_madvise(mapping, file_size, POSIX_MADV_SEQUENTIAL);
+        parsed = parse_content(std::string_view(static_cast<const char*>(mapping), file_size));
+        munmap(mapping, file_size);
+        return true;
+#else
+        (void)config_path;
+        (void)parse_content;
+        (void)parsed;
+        return false;
+#endif
+    }
+
+    bool NativeParser::read_file(const path& config_path, bool memory_map,
+                                 const std::function<bool(std::string_view)>& parse_content) {
+        bool parsed = false;
+
+        if (memory_map && map_file(config_path, parse_content, parsed)) {
+            return parsed;
+        }
+
+        std::unique_ptr<FILE, decltype(&std::fclose)> config_file(std::fopen(config_path.c_str(), "rb"), &std::fclose);
+
+        if (!config_file) {
+            return false;
+        }
+
+        std::string content;
+        char buffer[1 << 16];
+
+        for (size_t read = 0; (read = std::fread(buffer, 1, sizeof(buffer), config_file.get())) > 0;) {
+            content.append(buffer, read);
+        }
+
+        return parse_content(content);
+    }
+
+    bool NativeParser::parse_statements(Section& section, bool nested) {
+        Token name, next;
+
+        while (true) {
+            next_token(name);
+
+            switch (name.type) {
+                case TokenType::end:
+                    return !nested;
+                case TokenType::close_brace:
+                    return nested;
+                case TokenType::string:
+                    break;
+                default:
+                    return false;
+            }
+
+            auto element = section.child(name.text);
+
+            if (!element) {
+                return false;
+            }
+
+            // Elements outside of the projection are only checked against the tree, their content is skipped
+            if (!nested && m_projection && !is_projected(*m_projection, name.text)) {
+                if (!skip_statement()) {
+                    return false;
+                }
+                continue;
+            }
+
+            next_token(next);
+
+            bool valid = false;
+            switch (next.type) {
+                case TokenType::equal:
+                case TokenType::plus_equal:
+                    valid = parse_values(*element, next.type == TokenType::plus_equal);
+                    break;
+                case TokenType::open_brace:
+                    valid = parse_section(*element, nullptr, !nested);
+                    break;
+                case TokenType::string: {
+                    Token brace;
+                    next_token(brace);
+                    valid = brace.type == TokenType::open_brace && parse_section(*element, &next, !nested);
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            if (!valid) {
+                return false;
+            }
+        }
+    }
+
+    bool NativeParser::parse_values(Section::variant_type& element, bool append) {
+        Token value;
+        next_token(value);
+
+        if (value.type == TokenType::string) {
+            return assign(element, value.text, append);
+        }
+
+        if (value.type != TokenType::open_brace) {
+            return false;
+        }
+
+        bool is_list_option = std::visit(
+            [](auto& option) {
+                using current_type = std::decay_t<decltype(option)>;
+
+                if constexpr (std::is_same_v<current_type, Section> || std::is_same_v<current_type, Multisection> ||
+                              std::is_same_v<current_type, Function>) {
+                    return false;
+                } else {
+                    return is_list<std::decay_t<decltype(option.m_value)>>::value;
+                }
+            },
+            element);
+
+        if (!is_list_option) {
+            return false;
+        }
+
+        bool first = true;
+        while (true) {
+            next_token(value);
+
+            if (value.type == TokenType::close_brace && first) {
+                return append || assign(element, {}, false);
+            }
+
+            if (value.type != TokenType::string || !assign(element, value.text, append || !first)) {
+                return false;
+            }
+
+            first = false;
+            next_token(value);
+
+            if (value.type == TokenType::close_brace) {
+                return true;
+            }
+
+            if (value.type != TokenType::comma) {
+                return false;
+            }
+        }
+    }
+
+    bool NativeParser::parse_section(Section::variant_type& element, const Token* title, bool top_level) {
+        bool deferred = top_level && m_blocks;
+        const char* content = m_current;
+
+        if (auto section = std::get_if<Section>(&element)) {
+            if (title) {
+                return false;
+            }
+
+            if (!deferred) {
+                return parse_statements(*section, true);
+            }
+
+            if (!skip_block()) {
+                return false;
+            }
+
+            m_blocks->push_back({section, nullptr, 0, std::string_view(content, m_current - 1 - content), 0});
+            return true;
+        }
+
+        auto multisection = std::get_if<Multisection>(&element);
+
+        if (!multisection || !title) {
+            return false;
+        }
+
+        if (top_level && multisection == m_streamed) {
+            Section streamed_section(multisection->m_prototype);
+            streamed_section.title(std::string(title->text));
+
+            if (!reset(streamed_section) || !parse_statements(streamed_section, true)) {
+                return false;
+            }
+
+            build_indexes(streamed_section);
+            (*m_visitor)(streamed_section);
+            return true;
+        }
+
+        size_t section_index = multisection->find_title(title->text);
+
+        if (section_index == multisection->m_sections.size()) {
+            auto& created_section = multisection->m_sections.emplace_back(multisection->m_prototype);
+            created_section.title(std::string(title->text));
+            multisection->index_title(section_index);
+            reset(created_section);
+        } else if (!deferred) {
+            // A repeated title replaces the earlier section at its position, like cfg_setopt of confuse does it
+            replace(*multisection, multisection->m_sections[section_index]);
+        }
+
+        if (!deferred) {
+            return parse_statements(multisection->m_sections[section_index], true);
+        }
+
+        // m_sections may still grow, so the section is referred to by its index until every block is found
+        if (!skip_block()) {
+            return false;
+        }
+
+        m_blocks->push_back(
+            {nullptr, multisection, section_index, std::string_view(content, m_current - 1 - content), 0});
+        return true;
+    }
+
+    bool NativeParser::skip_statement() {
+        Token next;
+        next_token(next);
+
+        switch (next.type) {
+            case TokenType::equal:
+            case TokenType::plus_equal:
+                next_token(next);
+                return next.type == TokenType::string || (next.type == TokenType::open_brace && skip_block());
+            case TokenType::open_brace:
+                return skip_block();
+            case TokenType::string:
+                next_token(next);
+                return next.type == TokenType::open_brace && skip_block();
+            default:
+                return false;
+        }
+    }
+
+    bool NativeParser::skip_block() {
+        size_t depth = 1;
+
+        while (m_current < m_end) {
+            switch (*m_current) {
+                case '{':
+                    ++depth;
+                    ++m_current;
+                    break;
+                case '}':
+                    ++m_current;
+                    if (--depth == 0) {
+                        return true;
+                    }
+                    break;
+                case '"':
+                case '\'': {
+                    // Only the end of the string matters, so every escaped character is skipped
+                    char quote = *m_current++;
+                    while ((m_current = find_either(m_current, m_end, quote, '\\')) < m_end && *m_current == '\\') {
+                        // A backslash at the end of the buffer has nothing to escape
+                        m_current = m_current + 1 < m_end ? m_current + 2 : m_end;
+                    }
+                    if (m_current >= m_end) {
+                        return false;
+                    }
+                    ++m_current;
+                    break;
+                }
+                case '#':
+                case '/':
+                    if (*m_current == '#' || (m_current + 1 < m_end && (m_current[1] == '/' || m_current[1] == '*'))) {
+                        skip_whitespace();
+                    } else {
+                        ++m_current;
+                    }
+                    break;
+                default:
+                    ++m_current;
+                    break;
+            }
+        }
+
+        return false;
+    }
+
+    bool NativeParser::assign(Section::variant_type& element, std::string_view value, bool append) {
+        return std::visit(
+            [value, append](auto& option) {
+                using current_type = std::decay_t<decltype(option)>;
+
+                if constexpr (std::is_same_v<current_type, Section> || std::is_same_v<current_type, Multisection> ||
+                              std::is_same_v<current_type, Function>) {
+                    return false;
+                } else {
+                    using value_type = std::decay_t<decltype(option.m_value)>;
+
+                    if constexpr (is_list<value_type>::value) {
+                        if (!append) {
+                            option.m_value.clear();
+                        }
+
+                        // An empty value clears the list, it comes from "= {}"
+                        if (value.data() == nullptr) {
+                            return true;
+                        }
+
+                        typename value_type::value_type converted{};
+                        if (!convert(value, converted)) {
+                            return false;
+                        }
+
+                        option.m_value.push_back(std::move(converted));
+                        return true;
+                    } else {
+                        return !append && convert(value, option.m_value);
+                    }
+                }
+            },
+            element);
+    }
+
+    void NativeParser::skip_whitespace() {
+        while (m_current < m_end) {
+            char current = *m_current;
+
+            if (is_whitespace(current)) {
+                ++m_current;
+            } else if (current == '#' || (current == '/' && m_current + 1 < m_end && m_current[1] == '/')) {
+                auto line_end = static_cast<const char*>(std::memchr(m_current, '\n', m_end - m_current));
+                m_current = line_end ? line_end + 1 : m_end;
+            } else if (current == '/' && m_current + 1 < m_end && m_current[1] == '*') {
+                m_current += 2;
+
+                while (true) {
+                    m_current = find_either(m_current, m_end, '*', '*');
+
+                    if (m_current + 1 >= m_end) {
+                        m_current = m_end;
+                        break;
+                    }
+
+                    if (m_current[1] == '/') {
+                        m_current += 2;
+                        break;
+                    }
+
+                    ++m_current;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    void NativeParser::next_token(Token& token) {
+        skip_whitespace();
+        token.unescaped.clear();
+        token.text = {};
+
+        if (m_current == m_end) {
+            token.type = TokenType::end;
+            return;
+        }
+
+        const char* start = m_current;
+
+        switch (*m_current) {
+            case '=':
+                token.type = TokenType::equal;
+                ++m_current;
+                return;
+            case '{':
+                token.type = TokenType::open_brace;
+                ++m_current;
+                return;
+            case '}':
+                token.type = TokenType::close_brace;
+                ++m_current;
+                return;
+            case '(':
+                token.type = TokenType::open_paren;
+                ++m_current;
+                return;
+            case ',':
+                token.type = TokenType::comma;
+                ++m_current;
+                return;
+            case '"':
+            case '\'':
+                token.type = read_quoted(token, *m_current) ? TokenType::string : TokenType::invalid;
+                return;
+            case '+':
+                if (m_current + 1 < m_end && m_current[1] == '=') {
+                    token.type = TokenType::plus_equal;
+                    m_current += 2;
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+
+        while (m_current < m_end && !delimiters[static_cast<unsigned char>(*m_current)]) {
+            if ((*m_current == '+' && m_current + 1 < m_end && m_current[1] == '=') ||
+                (*m_current == '/' && m_current + 1 < m_end && (m_current[1] == '/' || m_current[1] == '*'))) {
+                break;
+            }
+            ++m_current;
+        }
+
+        if (m_current == start) {
+            token.type = TokenType::invalid;
+            ++m_current;
+            return;
+        }
+
+        token.text = std::string_view(start, m_current - start);
+        token.type = uses_environment(token.text) ? TokenType::invalid : TokenType::string;
+    }
+
+    bool NativeParser::read_quoted(Token& token, char quote) {
+        const char* start = ++m_current;
+        const char* closing = find_either(m_current, m_end, quote, '\\');
+
+        // Strings without escape sequences are referenced in place
+        if (closing < m_end && *closing == quote) {
+            token.text = std::string_view(start, closing - start);
+            m_current = closing + 1;
+            // Only double quoted strings are substituted by confuse
+            return quote == '\'' || !uses_environment(token.text);
+        }
+
+        token.unescaped.assign(start, closing);
+        m_current = closing;
+
+        while (m_current < m_end && *m_current != quote) {
+            if (*m_current != '\\') {
+                const char* next = find_either(m_current, m_end, quote, '\\');
+                token.unescaped.append(m_current, next);
+                m_current = next;
+                continue;
+            }
+
+            if (++m_current == m_end) {
+                return false;
+            }
+
+            char escaped = *m_current++;
+
+            if (quote == '\'') {
+                // Single quoted strings only know \' and \\ as escape sequences
+                if (escaped != '\'' && escaped != '\\') {
+                    token.unescaped.push_back('\\');
+                }
+                token.unescaped.push_back(escaped);
+                continue;
+            }
+
+            switch (escaped) {
+                case 'n':
+                    token.unescaped.push_back('\n');
+                    break;
+                case 'r':
+                    token.unescaped.push_back('\r');
+                    break;
+                case 't':
+                    token.unescaped.push_back('\t');
+                    break;
+                case 'f':
+                    token.unescaped.push_back('\f');
+                    break;
+                case 'b':
+                    token.unescaped.push_back('\b');
+                    break;
+                case 'a':
+                    token.unescaped.push_back('\a');
+                    break;
+                case 'x':
+                case 'X': {
+                    unsigned value = 0;
+                    const char* digits_end = std::min(m_current + 2, m_end);
+                    auto [end, error] = std::from_chars(m_current, digits_end, value, 16);
+                    if (error != std::errc()) {
+                        return false;
+                    }
+                    token.unescaped.push_back(static_cast<char>(value));
+                    m_current = end;
+                    break;
+                }
+                default:
+                    if (escaped >= '0' && escaped <= '7') {
+                        unsigned value = 0;
+                        const char* digits_end = std::min(m_current + 2, m_end);
+                        auto [end, error] = std::from_chars(m_current - 1, digits_end, value, 8);
+                        (void)error;
+                        token.unescaped.push_back(static_cast<char>(value));
+                        m_current = end;
+                    } else {
+                        token.unescaped.push_back(escaped);
+                    }
+                    break;
+            }
+        }
+
+        if (m_current == m_end) {
+            return false;
+        }
+
+        // The source is checked, so an escaped '$' is rejected as well
+        if (quote == '"' && uses_environment(std::string_view(start, m_current - start))) {
+            return false;
+        }
+
+        ++m_current;
+        token.text = token.unescaped;
+        return true;
+    }
+
+    void NativeParser::replace(const Multisection& multisection, Section& section) {
+        std::string title = std::move(section.m_title);
+        section = multisection.m_prototype;
+        section.m_title = std::move(title);
+        reset(section);
+    }
+
+    bool NativeParser::reset(Section& section) {
+        if (section.m_binding) {
+            return false;
+        }
+
+        for (auto& [identifier, element] : section.m_values) {
+            bool supported = std::visit(
+                [](auto& current) {
+                    using current_type = std::decay_t<decltype(current)>;
+
+                    if constexpr (std::is_same_v<current_type, Section>) {
+                        return reset(current);
+                    } else if constexpr (std::is_same_v<current_type, Multisection>) {
+                        current.m_sections.clear();
+                        current.m_title_slots.clear();
+                        current.m_columns.clear();
+                        return !current.m_binding;
+                    } else if constexpr (std::is_same_v<current_type, Function>) {
+                        return true;
+                    } else {
+                        // Without a default confuse yields zero, an empty string or an empty list
+                        if (!current.m_has_default_value) {
+                            current.m_value = std::decay_t<decltype(current.m_value)>();
+                        }
+                        return true;
+                    }
+                },
+                element);
+
+            if (!supported) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void NativeParser::build_indexes(Section& section) {
+        for (auto& [identifier, element] : section.m_values) {
+            if (auto child = std::get_if<Section>(&element)) {
+                build_indexes(*child);
+            } else if (auto multisection = std::get_if<Multisection>(&element)) {
+                for (auto& titled_section : multisection->m_sections) {
+                    build_indexes(titled_section);
+                }
+                multisection->build_indexes();
+            }
+        }
+    }
+
+}  // namespace confusepp
@@ -0,0 +1,71 @@
+#include <cstring>
+
+#include "path_index.h"
+
+namespace confusepp {
+
+    PathIndex::PathIndex(const Section& root) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::pair<std::string, ElementRef>> paths;
+        collect(root, "", paths);
+
+        size_t number_of_characters = 0;
+        for (const auto& current : paths) {
+            number_of_characters += current.first.size();
+        }
+
+        m_paths = std::make_unique<char[]>(number_of_characters);
+        m_entries.reserve(paths.size());
+
+        size_t offset = 0;
+        for (const auto& [element_path, entry] : paths) {
+            std::memcpy(m_paths.get() + offset, element_path.data(), element_path.size());
+            m_entries.emplace(std::string_view(m_paths.get() + offset, element_path.size()), entry);
+            offset += element_path.size();
+        }
+
+        // Every node of the unordered_map holds the entry, the cached hash and the pointer to the next node
+        m_bytes = number_of_characters + m_entries.bucket_count() * sizeof(void*) +
+                  m_entries.size() * (sizeof(decltype(m_entries)::value_type) + sizeof(size_t) + sizeof(void*));
+        m_build_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    void PathIndex::collect(const Section& section, const std::string& prefix,
+                            std::vector<std::pair<std::string, ElementRef>>& paths) {
+        for (const auto& [identifier, element] : section.m_values) {
+            std::string element_path = prefix.empty() ? std::string() : prefix + '/';
+            element_path.append(identifier);
+            paths.emplace_back(element_path, ElementRef(&element));
+
+            if (auto child = std::get_if<Section>(&element)) {
+                collect(*child, element_path, paths);
+            } else if (auto child = std::get_if<Multisection>(&element)) {
+                collect(*child, element_path, paths);
+            }
+        }
+    }
+
+    void PathIndex::collect(const Multisection& multisection, const std::string& prefix,
+                            std::vector<std::pair<std::string, ElementRef>>& paths) {
+        for (const auto& section : multisection.m_sections) {
+            std::string element_path = prefix + '/' + section.title();
+            paths.emplace_back(element_path, ElementRef(&section));
+            collect(section, element_path, paths);
+        }
+    }
+
+    bool PathIndex::is_canonical(std::string_view element_path) {
+        return !element_path.empty() && element_path.front() != '/' && element_path.back() != '/' &&
+               element_path.find("//") == std::string_view::npos;
+    }
+
+    bool PathIndex::empty() const { return m_entries.empty(); }
+
+    size_t PathIndex::size() const { return m_entries.size(); }
+
+    size_t PathIndex::bytes() const { return m_bytes; }
+
+    std::chrono::nanoseconds PathIndex::build_time() const { return m_build_time; }
+
+}  // namespace confusepp
@@ -0,0 +1,221 @@
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+#include "query.h"
+
+namespace confusepp {
+
+    namespace {
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+                text.remove_prefix(1);
+            }
+
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+                text.remove_suffix(1);
+            }
+
+            return text;
+        }
+
+        template<typename T, typename Comparison>
+        bool compare(const T& lhs, const T& rhs, Comparison comparison) {
+            switch (comparison) {
+                case Comparison::equal:
+                    return lhs == rhs;
+                case Comparison::not_equal:
+                    return lhs != rhs;
+                case Comparison::less:
+                    return lhs < rhs;
+                case Comparison::less_equal:
+                    return lhs <= rhs;
+                case Comparison::greater:
+                    return lhs > rhs;
+                case Comparison::greater_equal:
+                    return lhs >= rhs;
+            }
+            return false;
+        }
+    }  // namespace
+
+    std::optional<Query> Query::compile(std::string_view query) {
+        Query compiled;
+        compiled.m_text = query;
+
+        size_t position = 0;
+
+        while (position < query.size()) {
+            size_t segment_end = position;
+            bool in_predicate = false, in_quotes = false;
+
+            // '/' only separates segments outside of predicates and quoted literals
+            for (; segment_end < query.size(); ++segment_end) {
+                char current = query[segment_end];
+
+                if (in_quotes) {
+                    in_quotes = current != '"';
+                } else if (current == '"') {
+                    in_quotes = in_predicate;
+                } else if (current == '[') {
+                    in_predicate = true;
+                } else if (current == ']') {
+                    in_predicate = false;
+                } else if (current == '/' && !in_predicate) {
+                    break;
+                }
+            }
+
+            if (in_predicate || in_quotes) {
+                return {};
+            }
+
+            std::string_view segment = query.substr(position, segment_end - position);
+            position = segment_end + 1;
+
+            if (segment.empty()) {
+                continue;
+            }
+
+            Step step{std::string(segment), false, std::nullopt};
+
+            if (size_t predicate_start = segment.find('['); predicate_start != std::string_view::npos) {
+                if (segment.back() != ']') {
+                    return {};
+                }
+
+                step.name = segment.substr(0, predicate_start);
+                step.predicate =
+                    compile_predicate(segment.substr(predicate_start + 1, segment.size() - predicate_start - 2));
+
+                if (!step.predicate) {
+                    return {};
+                }
+            }
+
+            if (step.name.find_first_of("[]") != std::string::npos || step.name.empty()) {
+                return {};
+            }
+
+            step.wildcard = step.name == "*";
+            compiled.m_steps.push_back(std::move(step));
+        }
+
+        if (compiled.m_steps.empty()) {
+            return {};
+        }
+
+        return compiled;
+    }
+
+    std::optional<Query::Predicate> Query::compile_predicate(std::string_view predicate) {
+        size_t operator_start = predicate.find_first_of("!<>=");
+
+        if (operator_start == std::string_view::npos) {
+            return {};
+        }
+
+        size_t operator_end = operator_start + 1;
+        if (operator_end < predicate.size() && predicate[operator_end] == '=') {
+            ++operator_end;
+        }
+
+        std::string_view comparison_text = predicate.substr(operator_start, operator_end - operator_start);
+        Comparison comparison;
+
+        if (comparison_text == "=" || comparison_text == "==") {
+            comparison = Comparison::equal;
+        } else if (comparison_text == "!=") {
+            comparison = Comparison::not_equal;
+        } else if (comparison_text == "<") {
+            comparison = Comparison::less;
+        } else if (comparison_text == "<=") {
+            comparison = Comparison::less_equal;
+        } else if (comparison_text == ">") {
+            comparison = Comparison::greater;
+        } else if (comparison_text == ">=") {
+            comparison = Comparison::greater_equal;
+        } else {
+            return {};
+        }
+
+        std::string_view field = trim(predicate.substr(0, operator_start));
+        std::string_view literal = trim(predicate.substr(operator_end));
+
+        if (field.empty() || literal.empty()) {
+            return {};
+        }
+
+        bool quoted = literal.size() >= 2 && literal.front() == '"' && literal.back() == '"';
+        if (quoted) {
+            literal = literal.substr(1, literal.size() - 2);
+        }
+
+        Predicate compiled{std::string(field), comparison, std::string(literal), seeded_hash(literal, 0), std::nullopt};
+
+        if (!quoted) {
+            char* number_end = nullptr;
+            double number = std::strtod(compiled.literal.c_str(), &number_end);
+
+            if (number_end == compiled.literal.c_str() + compiled.literal.size()) {
+                // The literal is converted to float for float fields, a number outside of that range can't match
+                if (!std::isfinite(number) || std::fabs(number) > std::numeric_limits<float>::max()) {
+                    return {};
+                }
+
+                compiled.number = number;
+            }
+        }
+
+        return compiled;
+    }
+
+    bool Query::matches(const Section& section, const Predicate& predicate) {
+        const Section* current = &section;
+        const Section::variant_type* element = nullptr;
+
+        for (auto segment : PathSegments(predicate.field)) {
+            if (!current) {
+                return false;
+            }
+
+            element = current->child(segment);
+
+            if (!element) {
+                return false;
+            }
+
+            current = std::get_if<Section>(element);
+        }
+
+        if (!element) {
+            return false;
+        }
+
+        return std::visit(
+            [&predicate](const auto& option) {
+                using current_type = std::decay_t<decltype(option)>;
+
+                if constexpr (std::is_same_v<current_type, Option<int>>) {
+                    return predicate.number &&
+                           compare<double>(option.value(), *predicate.number, predicate.comparison);
+                } else if constexpr (std::is_same_v<current_type, Option<float>>) {
+                    return predicate.number &&
+                           compare<float>(option.value(), *predicate.number, predicate.comparison);
+                } else if constexpr (std::is_same_v<current_type, Option<bool>>) {
+                    return (predicate.literal == "true" || predicate.literal == "false") &&
+                           compare<bool>(option.value(), predicate.literal == "true", predicate.comparison);
+                } else if constexpr (std::is_same_v<current_type, Option<std::string>>) {
+                    return compare<std::string_view>(option.value(), predicate.literal, predicate.comparison);
+                } else {
+                    return false;
+                }
+            },
+            *element);
+    }
+
+    const std::string& Query::text() const { return m_text; }
+
+}  // namespace confusepp
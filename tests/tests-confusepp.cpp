@@ -1,6 +1,18 @@
 #include <experimental/filesystem>
 
+#include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 #include "catch.hpp"
 
@@ -8,6 +20,131 @@
 
 using std::experimental::filesystem::path;
 
+// Counts every heap allocation, so tests can check that lookups don't allocate
+static std::atomic<size_t> number_of_allocations = 0;
+
+void* operator new(size_t size) {
+    ++number_of_allocations;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+// Generated configs are written into a temporary directory, which is removed at the end of the test
+class TemporaryDirectory final {
+   public:
+    TemporaryDirectory() {
+        std::string name = (std::experimental::filesystem::temp_directory_path() / "confusepp-XXXXXX").string();
+        REQUIRE(mkdtemp(name.data()));
+        m_path = name;
+    }
+
+    ~TemporaryDirectory() { std::experimental::filesystem::remove_all(m_path); }
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    path write(const std::string& file_name, const std::string& content) const {
+        path file_path = m_path / file_name;
+        std::ofstream(file_path) << content;
+        return file_path;
+    }
+
+   private:
+    path m_path;
+};
+
+template<typename T>
+bool same_value(const confusepp::FlatTree& lhs, const confusepp::FlatTree::Node& lhs_node,
+                const confusepp::FlatTree& rhs, const confusepp::FlatTree::Node& rhs_node) {
+    return lhs.value<T>(lhs_node) == rhs.value<T>(rhs_node);
+}
+
+template<typename T>
+bool same_range(const confusepp::FlatTree& lhs, const confusepp::FlatTree::Node& lhs_node,
+                const confusepp::FlatTree& rhs, const confusepp::FlatTree::Node& rhs_node) {
+    auto lhs_range = lhs.value<confusepp::FlatTree::Range<T>>(lhs_node);
+    auto rhs_range = rhs.value<confusepp::FlatTree::Range<T>>(rhs_node);
+    return lhs_range && rhs_range &&
+           std::equal(lhs_range->begin(), lhs_range->end(), rhs_range->begin(), rhs_range->end());
+}
+
+// Walks two loaded trees side by side, returns the path of the first node which differs or an empty string
+std::string first_difference(const confusepp::FlatTree& lhs, const confusepp::FlatTree::Node& lhs_node,
+                             const confusepp::FlatTree& rhs, const confusepp::FlatTree::Node& rhs_node,
+                             const std::string& node_path = "/") {
+    using NodeType = confusepp::FlatTree::NodeType;
+
+    if (lhs_node.name() != rhs_node.name() || lhs_node.type() != rhs_node.type()) {
+        return node_path;
+    }
+
+    bool same = true;
+
+    switch (lhs_node.type()) {
+        case NodeType::section:
+        case NodeType::multisection: {
+            auto lhs_children = lhs.children(lhs_node);
+            auto rhs_children = rhs.children(rhs_node);
+
+            if (lhs_children.size() != rhs_children.size()) {
+                return node_path;
+            }
+
+            for (size_t index = 0; index < lhs_children.size(); ++index) {
+                auto child_path = node_path + std::string(lhs_children[index].name()) + "/";
+                auto difference = first_difference(lhs, lhs_children[index], rhs, rhs_children[index], child_path);
+
+                if (!difference.empty()) {
+                    return difference;
+                }
+            }
+            break;
+        }
+        case NodeType::integer:
+            same = same_value<int>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::floating:
+            same = same_value<float>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::boolean:
+            same = same_value<bool>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::string:
+            same = same_value<std::string_view>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::int_list:
+            same = same_range<int>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::float_list:
+            same = same_range<float>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::bool_list:
+            same = same_range<bool>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::string_list:
+            same = same_range<std::string_view>(lhs, lhs_node, rhs, rhs_node);
+            break;
+        case NodeType::function:
+            break;
+    }
+
+    return same ? std::string() : node_path;
+}
+
+std::string first_difference(const confusepp::FlatTree& lhs, const confusepp::FlatTree& rhs) {
+    if (!lhs.root() || !rhs.root()) {
+        return lhs.root() == rhs.root() ? std::string() : "/";
+    }
+
+    return first_difference(lhs, *lhs.root(), rhs, *rhs.root());
+}
+
 // TODO Tests with false arguments
 // TODO Tests boolean List and default_value
 // TODO remove unnecessary whitespaces in string for option name
@@ -175,4 +312,1231 @@ TEST_CASE("confusepp") {
         REQUIRE(person2->get<Option<int>>("age")->value() == 41);
         REQUIRE(person2->get<Option<float>>("constant")->value() == 0);
     }
+
+    SECTION("Zero-copy lookups") {
+        path section_path("person/euler");
+        path option_path("person/euler/age");
+        path wrong_path("person/euler/age/too_deep");
+
+        size_t allocations_before = number_of_allocations;
+        auto person = config->find<Section>(section_path);
+        auto age = config->find<Option<int>>(option_path);
+        auto wrong_type = config->find<Option<std::string>>(option_path);
+        auto too_deep = config->find<Option<int>>(wrong_path);
+        size_t allocations_after = number_of_allocations;
+
+        REQUIRE(allocations_after == allocations_before);
+        REQUIRE(person);
+        REQUIRE(age);
+        REQUIRE(!wrong_type);
+        REQUIRE(!too_deep);
+        REQUIRE(age->value() == 76);
+        REQUIRE(person->find<Option<int>>("age") == age);
+        REQUIRE(config->find<Multisection>("person")->find<Option<int>>("euler/age") == age);
+        REQUIRE(config->find<Section>(section_path) == person);
+        REQUIRE(!config->find<Section>("//"));
+        REQUIRE(!config->find<Section>("person/nobody"));
+    }
+
+    SECTION("Bindings") {
+        auto repeat = config->bind<Option<int>>("repeat");
+        auto age = config->bind<Option<int>>("person/turing/age");
+        auto firstname = config->bind<Option<std::string>>("/person/euler/firstname");
+        auto missing = config->bind<Option<int>>("person/nobody/age");
+
+        REQUIRE(repeat);
+        REQUIRE(age);
+        REQUIRE(firstname);
+        REQUIRE(!missing);
+        REQUIRE(repeat->value() == 3);
+        REQUIRE((*age).value() == 41);
+        REQUIRE(age.get() == config->find<Option<int>>("person/turing/age"));
+
+        Config moved_config(std::move(*config));
+
+        REQUIRE(firstname->value() == "Leonhard");
+        REQUIRE(firstname.get() == moved_config.find<Option<std::string>>("person/euler/firstname"));
+    }
+
+    SECTION("Split paths") {
+        constexpr auto age_path = "/person/euler/age/"_path;
+        constexpr auto capital_path = "capital_of_states_in_germany//Bavaria"_path;
+
+        static_assert(age_path.size() == 3);
+        static_assert(age_path[0] == "person" && age_path[1] == "euler" && age_path[2] == "age");
+        static_assert(capital_path.size() == 2);
+
+        REQUIRE(config->get<Option<int>>(age_path)->value() == 76);
+        REQUIRE(config->find<Option<int>>(age_path) == config->find<Option<int>>("person/euler/age"));
+        REQUIRE(config->bind<Option<std::string>>(capital_path)->value() == "Munich");
+        REQUIRE(config->get<Multisection>("person"_path)->get<Section>("turing"_path));
+        REQUIRE(!config->find<Option<int>>("person/euler/agee"_path));
+        REQUIRE_THROWS_AS("//"_path, const std::invalid_argument&);
+        REQUIRE_THROWS_AS("person/../person"_path, const std::invalid_argument&);
+    }
+
+    SECTION("String view lookups") {
+        std::string_view capital_path = "capital_of_states_in_germany/North Rhine-Westphalia";
+        std::string person_path = "/person/turing/";
+
+        size_t allocations_before = number_of_allocations;
+        auto capital = config->find<Option<std::string>>(capital_path);
+        auto person = config->find<Section>(person_path);
+        auto age = config->find<Option<int>>("person//euler/age");
+        auto nothing = config->find<Section>("///");
+        size_t allocations_after = number_of_allocations;
+
+        REQUIRE(allocations_after == allocations_before);
+        REQUIRE(capital->value() == "Düsseldorf");
+        REQUIRE(person == config->find<Section>(path("person/turing")));
+        REQUIRE(age->value() == 76);
+        REQUIRE(!nothing);
+        REQUIRE(config->get<Option<std::string>>(capital_path)->value() == "Düsseldorf");
+        REQUIRE(config->get<Multisection>(std::string_view("person"))->find<Section>(std::string("euler")));
+    }
+
+    SECTION("Flat tree") {
+        FlatTree flat_tree = config->flatten();
+
+        REQUIRE(flat_tree.size() > 0);
+        REQUIRE(flat_tree.root()->type() == FlatTree::NodeType::section);
+        REQUIRE(flat_tree.get<int>("repeat") == 3);
+        REQUIRE(flat_tree.get<std::string_view>("target") == std::string_view("Neighbour"));
+        REQUIRE(flat_tree.get<std::string_view>("capital_of_states_in_germany/Lower Saxony") ==
+                std::string_view("Hanover"));
+        REQUIRE(flat_tree.get<int>("person/euler/age") == 76);
+        REQUIRE(flat_tree.get<bool>("/person/turing/male/") == true);
+        REQUIRE(flat_tree.get<float>("person/euler/constant").value() - 2.71828182845F <= FLT_EPSILON);
+        REQUIRE(flat_tree.find("person")->type() == FlatTree::NodeType::multisection);
+        REQUIRE(flat_tree.children(*flat_tree.find("person")).size() == 2);
+        REQUIRE(!flat_tree.get<std::string_view>("person/euler/age"));
+        REQUIRE(!flat_tree.find("person/nobody"));
+        REQUIRE(!flat_tree.find("repeat/too_deep"));
+
+        auto lotto_numbers = flat_tree.get<FlatTree::Range<int>>("lotto_numbers");
+        REQUIRE(lotto_numbers->size() == 6);
+        REQUIRE(lotto_numbers->begin()[5] == 42);
+
+        auto presidents = flat_tree.get<FlatTree::Range<std::string_view>>("presidents");
+        REQUIRE(presidents->size() == 5);
+        REQUIRE((*presidents)[2] == "Thomas Jefferson");
+
+        auto booleans = flat_tree.get<FlatTree::Range<bool>>("a_boolean_list");
+        REQUIRE((std::vector<bool>(booleans->begin(), booleans->end()) ==
+                 std::vector<bool>{true, false, false, true, false}));
+        REQUIRE(flat_tree.get<FlatTree::Range<std::string_view>>("list with no default")->empty());
+
+        FlatTree moved_tree(std::move(flat_tree));
+        REQUIRE(!flat_tree.root());
+        REQUIRE(moved_tree.get<int>("person/turing/age"_path) == 41);
+    }
+
+    SECTION("Path index") {
+        REQUIRE(config->path_index().empty());
+
+        ParseOptions options;
+        options.build_path_index = true;
+        auto indexed_config = Config::parse("tests/tests.conf", root, options);
+        const auto& index = indexed_config->path_index();
+
+        REQUIRE(!index.empty());
+        REQUIRE(index.bytes() > 0);
+        REQUIRE(index.find<Option<int>>("person/turing/age")->value() == 41);
+        REQUIRE(index.find<Section>("person/euler") == indexed_config->find<Section>("/person/euler/"));
+        REQUIRE(index.find<Section>("capital_of_states_in_germany"));
+        REQUIRE(index.find<Multisection>("person"));
+        REQUIRE(!index.find<Option<std::string>>("person/turing/age"));
+        REQUIRE(!index.find<Section>("person/nobody"));
+
+        size_t allocations_before = number_of_allocations;
+        auto age = indexed_config->find<Option<int>>("person/euler/age");
+        size_t allocations_after = number_of_allocations;
+
+        REQUIRE(allocations_after == allocations_before);
+        REQUIRE(age == index.find<Option<int>>("person/euler/age"));
+        REQUIRE(indexed_config->get<Option<std::string>>(path("capital_of_states_in_germany/Hesse"))->value() ==
+                "Wiesbaden");
+        REQUIRE(indexed_config->get<Option<std::string>>("//capital_of_states_in_germany/Hesse")->value() ==
+                "Wiesbaden");
+    }
+
+    SECTION("Batched lookups") {
+        std::string_view paths[] = {"person/turing/age",
+                                    "person/euler/age",
+                                    "capital_of_states_in_germany/Hesse",
+                                    "person/euler/firstname",
+                                    "person/euler",
+                                    "/person/turing/lastname/",
+                                    "person/nobody/age",
+                                    "repeat/too_deep",
+                                    "",
+                                    "repeat"};
+        constexpr size_t number_of_paths = sizeof(paths) / sizeof(paths[0]);
+        ElementRef results[number_of_paths];
+
+        config->find_batch(paths, number_of_paths, results);
+
+        REQUIRE(results[0].get<Option<int>>() == config->find<Option<int>>(paths[0]));
+        REQUIRE(results[0].get<Option<int>>()->value() == 41);
+        REQUIRE(results[1].get<Option<int>>()->value() == 76);
+        REQUIRE(results[2].get<Option<std::string>>()->value() == "Wiesbaden");
+        REQUIRE(results[3].get<Option<std::string>>()->value() == "Leonhard");
+        REQUIRE(results[4].get<Section>() == config->find<Section>("person/euler"));
+        REQUIRE(results[5].get<Option<std::string>>()->value() == "Turing");
+        REQUIRE(!results[6]);
+        REQUIRE(!results[7]);
+        REQUIRE(!results[8]);
+        REQUIRE(results[9].get<Option<int>>()->value() == 3);
+        REQUIRE(!results[9].get<Option<std::string>>());
+    }
+
+    SECTION("Multisection titles") {
+        auto persons = config->find<Multisection>("person");
+        const auto& sections = persons->sections();
+
+        REQUIRE(sections.size() == 2);
+        REQUIRE(sections[0].title() == "turing");
+        REQUIRE(sections[1].title() == "euler");
+        REQUIRE(&sections[1] == persons->section("euler"));
+        REQUIRE(&sections[0] == config->find<Section>("person/turing"));
+        REQUIRE(!persons->section("gauss"));
+        REQUIRE((*persons)["turing"]->get<Option<int>>("age")->value() == 41);
+    }
+
+    SECTION("Columns") {
+        auto persons = config->find<Multisection>("person");
+        auto ages = persons->column<int>("age");
+        auto lastnames = persons->column<std::string>("lastname");
+        auto male = persons->column<bool>("male");
+
+        REQUIRE(ages);
+
+        // A column which was built once is found without a lock and without an allocation
+        size_t allocations_before = number_of_allocations;
+        REQUIRE(ages == persons->column<int>("age"));
+        REQUIRE(number_of_allocations == allocations_before);
+        REQUIRE((ages->values() == std::vector<int>{41, 76}));
+        REQUIRE(ages->titles()[0] == "turing");
+        REQUIRE(ages->titles()[1] == "euler");
+        REQUIRE(lastnames->values()[1] == "Euler");
+        REQUIRE(male->values()[0] == 1);
+        REQUIRE(persons->column<float>("constant")->size() == 2);
+        REQUIRE(!persons->column<int>("lastname"));
+        REQUIRE(!persons->column<int>("shoe_size"));
+
+        // Moving the Config keeps the sections and the columns which were built from them
+        Config moved(std::move(*config));
+        auto moved_persons = moved.find<Multisection>("person");
+        allocations_before = number_of_allocations;
+        REQUIRE(moved_persons->column<int>("age") == ages);
+        REQUIRE(number_of_allocations == allocations_before);
+        REQUIRE(moved_persons->column<int>("age")->titles()[1] == "euler");
+    }
+
+    SECTION("Field lookups without an index") {
+        auto persons = config->find<Multisection>("person");
+
+        REQUIRE(persons->find_equal<std::string>("lastname", "Euler")[0]->title() == "euler");
+        REQUIRE(persons->find_equal<std::string>("lastname", "Gauss").empty());
+        REQUIRE(persons->find_equal<std::string>("firstname", "Alan")[0]->title() == "turing");
+        REQUIRE(persons->find_range<int>("age", 40, 80).size() == 2);
+        REQUIRE(persons->find_range<float>("constant", 2.f, 3.f)[0]->title() == "euler");
+    }
+
+    SECTION("Queries") {
+        auto ages = Query::compile("person/*/age");
+        REQUIRE(ages);
+
+        std::vector<const Option<int>*> results;
+        config->query(*ages, results);
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0]->value() == 41);
+        REQUIRE(results[1]->value() == 76);
+
+        std::vector<const Option<std::string>*> names;
+        config->query(*Query::compile("person[age>50]/firstname"), names);
+        REQUIRE(names.size() == 1);
+        REQUIRE(names[0]->value() == "Leonhard");
+
+        config->query(*Query::compile("person[lastname = \"Turing\"]/firstname"), names);
+        REQUIRE(names.size() == 1);
+        REQUIRE(names[0]->value() == "Alan");
+
+        config->query(*Query::compile("person/*[firstname!=Alan]/lastname"), names);
+        REQUIRE(names.size() == 1);
+        REQUIRE(names[0]->value() == "Euler");
+
+        config->query(*Query::compile("person[constant>=2.5]/lastname"), names);
+        REQUIRE(names.size() == 1);
+
+        config->query(*Query::compile("*/Berlin"), names);
+        REQUIRE(names.size() == 1);
+        REQUIRE(names[0]->value() == "Berlin");
+
+        size_t number_of_results = 0;
+        config->for_each(*Query::compile("person/*"), [&number_of_results](const ElementRef& result) {
+            number_of_results += result.get<Section>() != nullptr;
+        });
+        REQUIRE(number_of_results == 2);
+
+        // Running a compiled query again doesn't allocate
+        size_t before = number_of_allocations;
+        config->query(*ages, results);
+        REQUIRE(number_of_allocations == before);
+
+        REQUIRE(!Query::compile(""));
+        REQUIRE(!Query::compile("person[age>40"));
+        REQUIRE(!Query::compile("person[age]"));
+        REQUIRE(!Query::compile("person[age>]/firstname"));
+        REQUIRE(!Query::compile("person[age=nan]"));
+        REQUIRE(!Query::compile("person[age<-inf]"));
+        REQUIRE(!Query::compile("person[constant>1e300]"));
+        REQUIRE(!Query::compile("person[constant>1e400]"));
+        REQUIRE(Query::compile("person[lastname=\"nan\"]"));
+    }
+
+    SECTION("Hot blocks") {
+        struct Hot {
+            int repeat;
+            float constant;
+            bool male;
+        };
+
+        auto hot = config->hot_block<Hot>(
+            {{"repeat", &Hot::repeat}, {"person/euler/constant", &Hot::constant}, {"person/turing/male", &Hot::male}});
+
+        REQUIRE(hot);
+        REQUIRE(reinterpret_cast<uintptr_t>(&hot->values()) % HotBlock<Hot>::cache_line_size == 0);
+        REQUIRE(hot->values().repeat == 3);
+        REQUIRE(hot->values().constant - 2.71828182845F <= FLT_EPSILON);
+        REQUIRE(hot->values().male);
+
+        REQUIRE(!config->hot_block<Hot>({{"target", &Hot::repeat}}));
+        REQUIRE(!config->hot_block<Hot>({{"does/not/exist", &Hot::male}}));
+    }
+
+    SECTION("Compiled schema") {
+        auto schema = CompiledSchema::compile(root);
+
+        for (int i = 0; i < 3; ++i) {
+            auto parsed = Config::parse("tests/tests.conf", schema);
+
+            REQUIRE(parsed);
+            REQUIRE(parsed->find<Option<int>>("repeat")->value() == 3);
+            REQUIRE(parsed->find<Option<std::string>>("person/euler/lastname")->value() == "Euler");
+            REQUIRE(parsed->find<Option<List<std::string>>>("presidents")->value().size() == 5);
+        }
+
+        REQUIRE(!Config::parse("tests/does_not_exist.conf", schema));
+
+        // Copies of the prototype share the parts of the schema, which never change
+        ConfigFormat copied(schema->prototype());
+        REQUIRE(copied.find<Option<List<std::string>>>("presidents")->value().default_value() ==
+                schema->prototype().find<Option<List<std::string>>>("presidents")->value().default_value());
+
+        // Measured by allocations instead of time, the schema isn't converted again for every parse
+        size_t before = number_of_allocations;
+        Config::parse("tests/tests.conf", root);
+        auto allocations_with_format = number_of_allocations - before;
+
+        before = number_of_allocations;
+        Config::parse("tests/tests.conf", schema);
+        auto allocations_with_schema = number_of_allocations - before;
+
+        REQUIRE(allocations_with_schema < allocations_with_format);
+    }
+
+    SECTION("Parse from buffer") {
+        std::ifstream config_file("tests/tests.conf");
+        std::string content((std::istreambuf_iterator<char>(config_file)), std::istreambuf_iterator<char>());
+
+        auto from_buffer = Config::parse_buffer(content, root);
+        REQUIRE(from_buffer);
+        REQUIRE(from_buffer->find<Option<std::string>>("target")->value() == "Neighbour");
+        REQUIRE(from_buffer->find<Option<int>>("person/turing/age")->value() == 41);
+        REQUIRE(!from_buffer->reload());
+
+        // The view ends in the middle of the buffer, so it isn't null terminated
+        std::string larger_buffer = "repeat = 7\nrepeat = \"broken";
+        auto from_view = Config::parse_buffer(std::string_view(larger_buffer).substr(0, 11), root);
+        REQUIRE(from_view);
+        REQUIRE(from_view->find<Option<int>>("repeat")->value() == 7);
+
+        REQUIRE(Config::parse_buffer(content, "tests", root));
+        REQUIRE(Config::parse_buffer(content, CompiledSchema::compile(root)));
+        REQUIRE(!Config::parse_buffer(larger_buffer, root));
+    }
+
+    SECTION("Native parser") {
+        ParseOptions native_options;
+        native_options.native_parser = true;
+
+        auto native = Config::parse("tests/tests.conf", root, native_options);
+        REQUIRE(native);
+        REQUIRE(first_difference(native->flatten(), config->flatten()) == "");
+
+        // The schema of the example program, every value of examples/example.conf has to load the same way
+        ConfigFormat example_format{
+            Option<int>("int_value").default_value(0),
+            Option<List<bool>>("bool_list").default_value(true, false),
+            Section("string_section").values(Option<std::string>("string_identifier").default_value("test_string")),
+            Multisection("int_section")
+                .values(Option<int>("int_one").default_value(13), Option<int>("int_two"), Option<int>("int_three")),
+            Multisection("multi").values(Option<std::string>("string_identifier")),
+            Option<List<int>>("int_list").default_value(42, 13),
+            Option<List<float>>("float_list"),
+            Option<List<std::string>>("string_list").default_value("test, test", "test2")};
+        auto example = Config::parse("examples/example.conf", example_format);
+        auto native_example = Config::parse("examples/example.conf", example_format, native_options);
+        REQUIRE(example);
+        REQUIRE(native_example);
+        REQUIRE(example->find<Section>("multi/title_two"));
+        REQUIRE(first_difference(native_example->flatten(), example->flatten()) == "");
+        std::ifstream example_file("examples/example.conf");
+        std::string changed_content((std::istreambuf_iterator<char>(example_file)), std::istreambuf_iterator<char>());
+        changed_content.replace(changed_content.find("int_value = 10"), 14, "int_value = 11");
+        auto changed_example = Config::parse_buffer(changed_content, example_format, native_options);
+        REQUIRE(first_difference(changed_example->flatten(), example->flatten()) == "/int_value/");
+
+        for (auto identifier : {"target", "firstname", "lastname", "capital_of_states_in_germany/Lower Saxony",
+                                "capital_of_states_in_germany/Baden-Württemberg", "person/euler/firstname"}) {
+            REQUIRE(native->find<Option<std::string>>(identifier)->value() ==
+                    config->find<Option<std::string>>(identifier)->value());
+        }
+
+        for (auto identifier : {"repeat", "age", "person/turing/age", "person/euler/age"}) {
+            REQUIRE(native->find<Option<int>>(identifier)->value() == config->find<Option<int>>(identifier)->value());
+        }
+
+        REQUIRE(native->find<Option<float>>("person/euler/constant")->value() ==
+                config->find<Option<float>>("person/euler/constant")->value());
+        REQUIRE(native->find<Option<float>>("person/turing/constant")->value() == .0f);
+        REQUIRE(native->find<Option<List<int>>>("lotto_numbers")->value() ==
+                config->find<Option<List<int>>>("lotto_numbers")->value());
+        REQUIRE(native->find<Option<List<float>>>("irrational_numbers")->value() ==
+                config->find<Option<List<float>>>("irrational_numbers")->value());
+        REQUIRE(native->find<Option<List<bool>>>("a_boolean_list")->value() ==
+                config->find<Option<List<bool>>>("a_boolean_list")->value());
+        REQUIRE(native->find<Option<List<std::string>>>("presidents")->value() ==
+                config->find<Option<List<std::string>>>("presidents")->value());
+        REQUIRE(native->find<Option<List<std::string>>>("empty_string_list")->value() ==
+                config->find<Option<List<std::string>>>("empty_string_list")->value());
+        REQUIRE(native->find<Option<List<std::string>>>("list with no default")->value().empty());
+        REQUIRE(native->find<Multisection>("person")->sections().size() == 2);
+        REQUIRE(native->find<Multisection>("person")->find_equal<std::string>("lastname", "Euler").size() == 1);
+
+        std::ifstream config_file("tests/tests.conf");
+        std::string content((std::istreambuf_iterator<char>(config_file)), std::istreambuf_iterator<char>());
+
+        auto schema = CompiledSchema::compile(root);
+        auto from_buffer = Config::parse_buffer(content, schema, native_options);
+        REQUIRE(from_buffer);
+        REQUIRE(from_buffer->find<Option<int>>("person/turing/age")->value() == 41);
+
+        // Reloading goes through libconfuse and has to yield the same tree
+        REQUIRE(native->reload());
+        REQUIRE(native->find<Option<std::string>>("person/turing/firstname")->value() == "Alan");
+    }
+}
+
+TEST_CASE("Secondary indexes") {
+    using namespace confusepp;
+
+    ConfigFormat root{Multisection("person")
+                          .values(Option<std::string>("firstname"), Option<std::string>("lastname"), Option<int>("age"),
+                                  Option<float>("constant").default_value(.0f))
+                          .index_on("lastname")
+                          .index_on("age")
+                          .index_on("constant")};
+
+    std::string content = "person turing { firstname = \"Alan\" lastname = \"Turing\" age = 41 }\n"
+                          "person euler { firstname = \"Leonhard\" lastname = \"Euler\" age = 76 constant = 2.5 }\n";
+    for (int i = 0; i < 100; ++i) {
+        content += "person p" + std::to_string(i) + " { lastname = \"name" + std::to_string(i % 10) +
+                   "\" age = " + std::to_string(i) + " }\n";
+    }
+
+    auto config = Config::parse_buffer(content, root);
+    REQUIRE(config);
+    auto persons = config->find<Multisection>("person");
+
+    auto eulers = persons->find_equal<std::string>("lastname", "Euler");
+    REQUIRE(eulers.size() == 1);
+    REQUIRE(eulers[0]->title() == "euler");
+    REQUIRE(persons->find_equal<std::string>("lastname", "Gauss").empty());
+    REQUIRE(persons->find_equal<int>("age", 41)[0]->title() == "turing");
+
+    // Sections with the same value are returned in the order of the file
+    auto name3 = persons->find_equal<std::string>("lastname", "name3");
+    REQUIRE(name3.size() == 10);
+    REQUIRE(name3[0]->title() == "p3");
+    REQUIRE(name3[9]->title() == "p93");
+
+    auto in_range = persons->find_range<int>("age", 40, 80);
+    REQUIRE(in_range.size() == 42);
+    REQUIRE(persons->find_range<int>("age", 77, 80).size() == 3);
+    REQUIRE(persons->find_range<float>("constant", 2.f, 3.f)[0]->title() == "euler");
+
+    // Fields without an index are scanned
+    REQUIRE(persons->find_equal<std::string>("firstname", "Alan")[0]->title() == "turing");
+
+    std::vector<const Option<std::string>*> names;
+    config->query(*Query::compile("person[lastname = \"Turing\"]/firstname"), names);
+    REQUIRE(names.size() == 1);
+    REQUIRE(names[0]->value() == "Alan");
+    config->query(*Query::compile("person[lastname=name7]/lastname"), names);
+    REQUIRE(names.size() == 10);
+    config->query(*Query::compile("person[age>75]/lastname"), names);
+    REQUIRE(names.size() == 25);
+    config->query(*Query::compile("person[constant>=2.5]/lastname"), names);
+    REQUIRE(names.size() == 1);
+    config->query(*Query::compile("person[age<=-3e9]/lastname"), names);
+    REQUIRE(names.empty());
+    config->query(*Query::compile("person[constant<3.4e38]/lastname"), names);
+    REQUIRE(names.size() == 102);
+
+    // NaN keys match no query and don't break the order of the other keys
+    ConfigFormat with_nan{
+        Multisection("point").values(Option<float>("x").default_value(std::nanf(""))).index_on("x")};
+    std::string points;
+    for (int i = 0; i < 64; ++i) {
+        points += "point p" + std::to_string(i) + (i % 3 ? " { }\n" : " { x = " + std::to_string(64 - i) + " }\n");
+    }
+
+    auto nan_config = Config::parse_buffer(points, with_nan);
+    REQUIRE(nan_config);
+    auto nan_points = nan_config->find<Multisection>("point");
+    REQUIRE(nan_points->find_range<float>("x", 0.f, 100.f).size() == 22);
+    REQUIRE(nan_points->find_equal<float>("x", 64.f)[0]->title() == "p0");
+    REQUIRE(nan_points->find_equal<float>("x", 1.f)[0]->title() == "p63");
+    REQUIRE(nan_points->find_equal<float>("x", std::nanf("")).empty());
+
+    FieldIndex<float> index;
+    index.build({{std::nanf(""), 0}, {2.f, 1}, {std::nanf(""), 2}, {1.f, 3}});
+    REQUIRE(index.size() == 2);
+    REQUIRE(index.at_least(0.f).begin()->second == 3);
+}
+
+TEST_CASE("PerfectHash") {
+    using namespace confusepp;
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back("option_" + std::to_string(i));
+    }
+
+    std::vector<std::pair<std::string_view, int>> entries;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        entries.emplace_back(keys[i], static_cast<int>(i));
+    }
+
+    PerfectHash<int> hash;
+    REQUIRE(hash.build(entries));
+    REQUIRE(hash.size() == keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(hash.find(keys[i]));
+        REQUIRE(*hash.find(keys[i]) == static_cast<int>(i));
+    }
+
+    REQUIRE(!hash.find("option_1000"));
+    REQUIRE(!hash.find(""));
+    REQUIRE(PerfectHash<int>().find("option_0") == nullptr);
+}
+
+TEST_CASE("Multisection with many titles") {
+    using namespace confusepp;
+
+    constexpr int number_of_persons = 2000;
+    std::string content;
+    for (int i = 0; i < number_of_persons; ++i) {
+        content += "person p" + std::to_string(i) + " {\n    age = " + std::to_string(i) + "\n}\n";
+    }
+
+    ConfigFormat root{
+        Multisection("person").values(Option<int>("age"), Option<std::string>("firstname")).index_on("age")};
+    auto config = Config::parse_buffer(content, root);
+
+    REQUIRE(config);
+    REQUIRE(config->find<Multisection>("person")->sections().size() == number_of_persons);
+    REQUIRE(config->find<Option<int>>("person/p0/age")->value() == 0);
+    REQUIRE(config->find<Option<int>>("person/p1234/age")->value() == 1234);
+    REQUIRE(config->find<Option<int>>("person/p1999/age")->value() == 1999);
+    REQUIRE(config->find<Section>("person/p1999")->title() == "p1999");
+    REQUIRE(config->find<Multisection>("person")->sections()[1234].title() == "p1234");
+
+    auto in_range = config->find<Multisection>("person")->find_range<int>("age", 40, 80);
+    REQUIRE(in_range.size() == 40);
+    REQUIRE(in_range.front()->title() == "p40");
+    REQUIRE(in_range.back()->title() == "p79");
+    REQUIRE(config->find<Multisection>("person")->find_equal<int>("age", 1500)[0]->title() == "p1500");
+
+    std::vector<const Option<int>*> ages;
+    config->query(*Query::compile("person[age>=1990]/age"), ages);
+    REQUIRE(ages.size() == 10);
+    REQUIRE(ages.front()->value() == 1990);
+
+    // Copies share the hash of the children, it has to outlive the Config the copy was taken from
+    auto copied = config->get<Section>("person/p42");
+    config.reset();
+    REQUIRE(copied->find<Option<int>>("age")->value() == 42);
+    REQUIRE(!copied->find<Option<int>>("agee"));
+}
+
+TEST_CASE("Reload") {
+    using namespace confusepp;
+
+    TemporaryDirectory directory;
+    auto write_config = [&directory](int repeat, const std::string& persons) {
+        return directory.write("reload.conf", "repeat = " + std::to_string(repeat) + "\n" + persons);
+    };
+
+    struct Hot {
+        int repeat;
+    };
+
+    path config_path = write_config(1, "person a { age = 1 }\nperson b { age = 2 }\n");
+
+    ConfigFormat root{Option<int>("repeat"), Option<std::string>("target").default_value("World"),
+                      Multisection("person").values(Option<int>("age")).index_on("age")};
+    auto config = Config::parse(config_path, root);
+
+    REQUIRE(config);
+    auto hot = config->hot_block<Hot>({{"repeat", &Hot::repeat}});
+    auto repeat = config->find<Option<int>>("repeat");
+    REQUIRE(hot->values().repeat == 1);
+
+    write_config(2, "person b { age = 3 }\n");
+    REQUIRE(config->reload());
+    REQUIRE(hot->values().repeat == 2);
+    REQUIRE(repeat->value() == 2);
+    REQUIRE(config->find<Multisection>("person")->sections().size() == 1);
+    REQUIRE(!config->find<Section>("person/a"));
+    REQUIRE(config->find<Option<int>>("person/b/age")->value() == 3);
+    REQUIRE(config->find<Multisection>("person")->find_equal<int>("age", 3).size() == 1);
+
+    // A broken file leaves the loaded values untouched
+    write_config(3, "person {");
+    REQUIRE(!config->reload());
+    REQUIRE(hot->values().repeat == 2);
+    REQUIRE(config->find<Option<int>>("person/b/age")->value() == 3);
+
+    auto person = config->hot_block<Hot>({{"person/b/age", &Hot::repeat}});
+    REQUIRE(person->valid());
+    write_config(4, "target = \"Moon\"\nperson b { age = 5 }\n");
+    REQUIRE(config->reload());
+    REQUIRE(config->find<Option<std::string>>("target")->value() == "Moon");
+    REQUIRE(person->values().repeat == 5);
+
+    // Removed options get their default back, a hot block which lost a field keeps its values, but is invalid
+    write_config(5, "person c { age = 6 }\n");
+    REQUIRE(!config->reload());
+    REQUIRE(config->find<Option<std::string>>("target")->value() == "World");
+    REQUIRE(hot->valid());
+    REQUIRE(hot->values().repeat == 5);
+    REQUIRE(!person->valid());
+    REQUIRE(person->values().repeat == 5);
+
+    write_config(6, "person b { age = 7 }\n");
+    REQUIRE(config->reload());
+    REQUIRE(person->valid());
+    REQUIRE(person->values().repeat == 7);
+}
+
+TEST_CASE("Struct binding") {
+    using namespace confusepp;
+
+    struct Person {
+        std::string title;
+        std::string firstname;
+        int age = 0;
+        bool male = false;
+        float constant = 1.5f;
+    };
+
+    struct Settings {
+        int repeat = 0;
+        std::string target = "nobody";
+    };
+
+    std::string content = "repeat = 3\n"
+                          "person turing { firstname = \"Alan\" age = 41 male = true }\n"
+                          "person euler { firstname = \"Leonhard\" age = 76 constant = 2.5 }\n";
+
+    auto format = StructFormat<Person>(
+                      {{"firstname", &Person::firstname}, {"age", &Person::age}, {"male", &Person::male},
+                       {"constant", &Person::constant}})
+                      .title(&Person::title);
+    ConfigFormat root{Multisection("person").bind(format)};
+    root.bind(StructFormat<Settings>({{"repeat", &Settings::repeat}, {"target", &Settings::target}}));
+
+    auto config = Config::parse_buffer(content, root);
+
+    REQUIRE(config);
+    const auto& persons = *config->find<Multisection>("person")->bound<Person>();
+    REQUIRE(persons.size() == 2);
+    REQUIRE(persons[0].title == "turing");
+    REQUIRE(persons[0].firstname == "Alan");
+    REQUIRE(persons[0].age == 41);
+    REQUIRE(persons[0].male);
+    REQUIRE(persons[0].constant == 1.5f);
+    REQUIRE(persons[1].title == "euler");
+    REQUIRE(persons[1].age == 76);
+    REQUIRE(!persons[1].male);
+    REQUIRE(persons[1].constant == 2.5f);
+    REQUIRE(config->find<Multisection>("person")->sections().empty());
+    REQUIRE(!config->find<Multisection>("person")->bound<Settings>());
+
+    REQUIRE(config->bound<Settings>()->repeat == 3);
+    REQUIRE(config->bound<Settings>()->target == "nobody");
+    REQUIRE(root.bound<Settings>()->repeat == 0);
+
+    // The bound options of the root aren't elements, so a projection doesn't skip them
+    ParseOptions projected;
+    projected.projection = {"target"};
+    auto projected_config = Config::parse_buffer(content, root, projected);
+    REQUIRE(projected_config);
+    REQUIRE(projected_config->bound<Settings>()->repeat == 3);
+    REQUIRE(projected_config->find<Multisection>("person")->bound<Person>()->empty());
+
+    // Every Config of a shared schema loads into its own structs
+    auto schema = CompiledSchema::compile(root);
+    std::atomic<size_t> number_of_matches = 0;
+    std::vector<std::thread> threads;
+
+    for (int thread_index = 0; thread_index < 4; ++thread_index) {
+        threads.emplace_back([&schema, &number_of_matches, thread_index] {
+            std::string numbered = "repeat = " + std::to_string(thread_index) + "\n";
+
+            for (int i = 0; i <= thread_index; ++i) {
+                numbered += "person p" + std::to_string(i) + " { age = " + std::to_string(thread_index) + " }\n";
+            }
+
+            auto numbered_config = Config::parse_buffer(numbered, schema);
+            const auto* numbered_persons = numbered_config->find<Multisection>("person")->bound<Person>();
+            number_of_matches += numbered_config->bound<Settings>()->repeat == thread_index &&
+                                 numbered_persons->size() == static_cast<size_t>(thread_index) + 1 &&
+                                 numbered_persons->back().age == thread_index;
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(number_of_matches == threads.size());
+    REQUIRE(schema->prototype().bound<Settings>()->repeat == 0);
+}
+
+TEST_CASE("Static format") {
+    using namespace confusepp;
+
+    struct repeat;
+    struct target;
+    struct capital;
+    struct berlin;
+    struct person;
+    struct age;
+    struct male;
+    struct constant;
+
+    TemporaryDirectory directory;
+    path config_path = directory.write("static_format.conf", "repeat = 3\n"
+                                                             "capital { Berlin = \"Berlin\" }\n"
+                                                             "person turing { age = 41 male = true }\n"
+                                                             "person euler { age = 76 constant = 2.5 }\n");
+
+    StaticFormat format(StaticOption<repeat, int>("repeat"),
+                        StaticOption<target, std::string>("target").default_value("Neighbour"),
+                        static_section<capital>("capital", StaticOption<berlin, std::string>("Berlin")),
+                        static_multisection<person>("person", StaticOption<age, int>("age"),
+                                                    StaticOption<male, bool>("male").default_value(false),
+                                                    StaticOption<constant, float>("constant").default_value(1.5f)));
+
+    auto config = format.parse(config_path);
+
+    REQUIRE(config);
+    REQUIRE(config->value<repeat>() == 3);
+    REQUIRE(config->value<target>() == "Neighbour");
+    REQUIRE(config->get<capital>().value<berlin>() == "Berlin");
+
+    const auto& persons = config->get<person>().sections();
+    REQUIRE(persons.size() == 2);
+    REQUIRE(persons[0].title() == "turing");
+    REQUIRE(persons[0].value<age>() == 41);
+    REQUIRE(persons[0].value<male>());
+    REQUIRE(persons[0].value<constant>() == 1.5f);
+    REQUIRE(config->get<person>().section("euler")->value<constant>() == 2.5f);
+    REQUIRE(!config->get<person>().section("gauss"));
+
+    static_assert(std::is_same_v<std::decay_t<decltype(config->value<repeat>())>, int>);
+    static_assert(static_index_of<berlin, StaticOption<repeat, int>>() == 1);
+
+    REQUIRE(!format.parse("tests/does_not_exist.conf"));
+}
+
+TEST_CASE("Memory mapped parsing") {
+    using namespace confusepp;
+
+    ConfigFormat root{Option<int>("repeat"), Multisection("person").values(Option<int>("age"), Option<std::string>(
+                                                                                                   "firstname"))};
+
+    // Large enough to span many pages, the mapped native parser and libconfuse have to load the same tree
+    std::string content = "repeat = 3\n";
+    for (int i = 0; i < 2000; ++i) {
+        content += "person p" + std::to_string(i) + " {\n    age = " + std::to_string(i) + "\n    firstname = \"name" +
+                   std::to_string(i) + "\"\n}\n";
+    }
+
+    TemporaryDirectory directory;
+    path config_path = directory.write("mapped.conf", content);
+
+    auto with_stdio = Config::parse(config_path, root);
+    ParseOptions mapped;
+    mapped.memory_map = true;
+    mapped.native_parser = true;
+    auto with_mapping = Config::parse(config_path, root, mapped);
+
+    REQUIRE(with_stdio);
+    REQUIRE(with_mapping);
+    REQUIRE(with_mapping->find<Multisection>("person")->sections().size() == 2000);
+    REQUIRE(with_mapping->find<Option<int>>("person/p1999/age")->value() == 1999);
+    REQUIRE(with_mapping->find<Option<std::string>>("person/p123/firstname")->value() ==
+            with_stdio->find<Option<std::string>>("person/p123/firstname")->value());
+    REQUIRE(with_mapping->reload());
+
+    // The native parser doesn't need a terminator, so a file which fills its last page completely is mapped as well
+    std::string page_sized_content = "repeat = 5\n";
+    page_sized_content.resize(sysconf(_SC_PAGESIZE), ' ');
+    path page_sized_path = directory.write("page_sized.conf", page_sized_content);
+
+    auto page_sized = Config::parse(page_sized_path, root, mapped);
+    REQUIRE(page_sized);
+    REQUIRE(page_sized->find<Option<int>>("repeat")->value() == 5);
+
+    // libconfuse reads through stdio, memory_map doesn't change it
+    mapped.native_parser = false;
+    auto page_sized_confuse = Config::parse(page_sized_path, root, mapped);
+    REQUIRE(page_sized_confuse);
+    REQUIRE(page_sized_confuse->find<Option<int>>("repeat")->value() == 5);
+
+    REQUIRE(!Config::parse("tests/does_not_exist.conf", root, mapped));
+}
+
+TEST_CASE("Native parser syntax") {
+    using namespace confusepp;
+
+    ConfigFormat root{Option<int>("int_value").default_value(0),
+                      Option<float>("float_value"),
+                      Option<List<bool>>("bool_list").default_value(true, false),
+                      Option<List<int>>("int_list").default_value(42, 13),
+                      Option<List<std::string>>("string_list").default_value("test, test", "test2"),
+                      Option<std::string>("string_value"),
+                      Section("string_section").values(Option<std::string>("string_identifier").default_value("test")),
+                      Multisection("int_section")
+                          .values(Option<int>("int_one").default_value(13), Option<int>("int_two"))};
+    ParseOptions native_parser;
+    native_parser.native_parser = true;
+
+    std::string content = R"(# line comment
+int_value = 0x1f // trailing comment
+float_value = -2.5e1
+/* block
+   comment */
+bool_list = {Yes, off, TRUE}
+int_list += {7, -010}
+string_list = {'single \'quoted\'', "tab\tnew\nline\x41\101", unquoted}
+string_value = "with \"escapes\""
+string_section { string_identifier = "Hello world" }
+int_section test {
+    int_two = 10
+}
+int_section 'second title' { int_one = 1 int_two = 2 }
+int_section test { int_one = 42 }
+)";
+
+    auto native = Config::parse_buffer(content, root, native_parser);
+    REQUIRE(native);
+
+    REQUIRE(native->find<Option<int>>("int_value")->value() == 31);
+    REQUIRE(native->find<Option<float>>("float_value")->value() == -25.0f);
+    REQUIRE(native->find<Option<List<bool>>>("bool_list")->value() == List<bool>(true, false, true));
+    REQUIRE(native->find<Option<List<int>>>("int_list")->value() == List<int>(42, 13, 7, -8));
+    REQUIRE(native->find<Option<std::string>>("string_value")->value() == "with \"escapes\"");
+    REQUIRE(native->find<Option<std::string>>("string_section/string_identifier")->value() == "Hello world");
+    REQUIRE(native->find<Multisection>("int_section")->sections().size() == 2);
+    // The second block of "test" replaces the first one, its position stays the one of the first block
+    REQUIRE(native->find<Multisection>("int_section")->sections()[0].title() == "test");
+    REQUIRE(native->find<Option<int>>("int_section/test/int_one")->value() == 42);
+    REQUIRE(native->find<Option<int>>("int_section/test/int_two")->value() == 0);
+    REQUIRE(native->find<Option<int>>("int_section/second title/int_two")->value() == 2);
+
+    auto with_confuse = Config::parse_buffer("int_section test { int_two = 10 }\nint_section other { }\n"
+                                             "int_section test { int_one = 42 }\n",
+                                             root);
+    REQUIRE(with_confuse);
+    REQUIRE(with_confuse->find<Multisection>("int_section")->sections()[0].title() == "test");
+    REQUIRE(with_confuse->find<Option<int>>("int_section/test/int_one")->value() == 42);
+    REQUIRE(with_confuse->find<Option<int>>("int_section/test/int_two")->value() == 0);
+
+    auto strings = native->find<Option<List<std::string>>>("string_list")->value();
+    REQUIRE(strings.size() == 3);
+    REQUIRE(strings[0] == "single 'quoted'");
+    REQUIRE(strings[1] == "tab\tnew\nlineAA");
+    REQUIRE(strings[2] == "unquoted");
+
+    REQUIRE(!Config::parse_buffer("unknown = 1", root, native_parser));
+    REQUIRE(!Config::parse_buffer("int_value = one", root, native_parser));
+    REQUIRE(!Config::parse_buffer("int_value = {1, 2}", root, native_parser));
+    REQUIRE(Config::parse_buffer("int_value = +5", root, native_parser)->find<Option<int>>("int_value")->value() == 5);
+    REQUIRE(!Config::parse_buffer("int_value = --5", root, native_parser));
+    REQUIRE(!Config::parse_buffer("int_value = +-5", root, native_parser));
+    REQUIRE(!Config::parse_buffer("int_value = 0x-5", root, native_parser));
+    REQUIRE(!Config::parse_buffer("float_value = +-2.5", root, native_parser));
+    REQUIRE(!Config::parse_buffer("string_value = \"unterminated", root, native_parser));
+    REQUIRE(!Config::parse_buffer("string_section { string_identifier = x", root, native_parser));
+    REQUIRE(!Config::parse_buffer("int_section { int_one = 1 }", root, native_parser));
+    REQUIRE(!Config::parse_buffer("}", root, native_parser));
+
+    // The blocks of a parallel parse are located by a scan, which has to stop at a backslash at the end
+    ParseOptions parallel_parser = native_parser;
+    parallel_parser.parse_threads = 2;
+    REQUIRE(!Config::parse_buffer("string_section { string_identifier = \"x\\", root, parallel_parser));
+
+    // confuse substitutes environment variables, which isn't supported
+    REQUIRE(!Config::parse_buffer("string_value = \"${HOME}\"", root, native_parser));
+    REQUIRE(!Config::parse_buffer("string_value = \"\\t${HOME}\"", root, native_parser));
+    REQUIRE(!Config::parse_buffer("string_value = ${HOME}", root, native_parser));
+    auto single_quoted = Config::parse_buffer("string_value = '${HOME}'", root, native_parser);
+    REQUIRE(single_quoted);
+    REQUIRE(single_quoted->find<Option<std::string>>("string_value")->value() == "${HOME}");
+    REQUIRE(Config::parse_buffer("string_value = \"$HOME {}\"", root, native_parser));
+
+    REQUIRE(!Config::parse("tests/does_not_exist.conf", root, native_parser));
+}
+
+TEST_CASE("Concurrent parsing") {
+    using namespace confusepp;
+
+    ConfigFormat root{Option<std::string>("target"), Option<int>("repeat"),
+                      Option<List<int>>("lotto_numbers").default_value(42),
+                      Multisection("person")
+                          .values(Option<std::string>("lastname"), Option<int>("age"))
+                          .index_on("lastname")};
+    auto schema = CompiledSchema::compile(root);
+
+    std::string content = "target = \"Neighbour\"\nrepeat = 3\nlotto_numbers = {4, 8, 15, 16, 23, 42}\n";
+    for (int i = 0; i < 100; ++i) {
+        content += "person p" + std::to_string(i) + " {\n    lastname = \"name" + std::to_string(i % 10) +
+                   "\"\n    age = " + std::to_string(i) + "\n}\n";
+    }
+    TemporaryDirectory directory;
+    path config_path = directory.write("concurrent.conf", content);
+
+    // Every thread parses with every method, the shared root and schema are only read
+    auto parse_all = [&root, &schema, &content, &config_path](ParseOptions options) {
+        std::vector<std::optional<Config>> configs;
+        configs.push_back(Config::parse(config_path, root, options));
+        configs.push_back(Config::parse(config_path, schema, options));
+        configs.push_back(Config::parse_buffer(content, root, options));
+        configs.push_back(Config::parse_buffer(content, schema, options));
+
+        bool valid = true;
+        for (const auto& config : configs) {
+            valid = valid && config && config->find<Option<int>>("person/p76/age")->value() == 76 &&
+                    config->find<Option<int>>("repeat")->value() == 3 &&
+                    config->find<Option<List<int>>>("lotto_numbers")->value().size() == 6 &&
+                    config->find<Multisection>("person")->find_equal<std::string>("lastname", "name3").size() == 10;
+        }
+        return valid;
+    };
+
+    std::atomic<size_t> number_of_valid_parses = 0;
+    std::vector<std::thread> threads;
+    size_t number_of_threads = std::max(4U, std::thread::hardware_concurrency());
+    constexpr size_t parses_per_thread = 25;
+
+    for (size_t thread_index = 0; thread_index < number_of_threads; ++thread_index) {
+        threads.emplace_back([&parse_all, &number_of_valid_parses, thread_index] {
+            for (size_t i = 0; i < parses_per_thread; ++i) {
+                ParseOptions options;
+                options.native_parser = (thread_index + i) % 2 == 0;
+                options.build_path_index = i % 3 == 0;
+                number_of_valid_parses += parse_all(options);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(number_of_valid_parses == number_of_threads * parses_per_thread);
+}
+
+TEST_CASE("Parallel native parsing") {
+    using namespace confusepp;
+
+    ConfigFormat root{Option<int>("repeat").default_value(1), Option<List<int>>("lotto_numbers"),
+                      Section("settings").values(Option<std::string>("name"), Option<List<std::string>>("tags")),
+                      Multisection("person")
+                          .values(Option<std::string>("firstname"), Option<int>("age"),
+                                  Option<List<int>>("numbers").default_value(0),
+                                  Section("address").values(Option<std::string>("city").default_value("Berlin")))
+                          .index_on("age")};
+
+    // Titles repeat, the last block of a title replaces the earlier ones
+    std::string content = "repeat = 3\nsettings { name = \"first\" tags = {\"a\"} }\n";
+    for (int i = 0; i < 2000; ++i) {
+        content += "person p" + std::to_string(i % 1500) + " {\n    firstname = \"name {" + std::to_string(i) +
+                   "}\" # not a brace }\n    age = " + std::to_string(i) + "\n    numbers += {" + std::to_string(i) +
+                   "}\n    address { city = 'City } " + std::to_string(i % 7) + "' }\n}\n";
+        if (i == 1000) {
+            content += "lotto_numbers = {4, 8}\nsettings { tags += {\"b\"} }\n/* } */ repeat = 4\n";
+        }
+    }
+
+    TemporaryDirectory directory;
+    path config_path = directory.write("parallel.conf", content);
+
+    ParseOptions serial_options, parallel_options;
+    serial_options.native_parser = parallel_options.native_parser = true;
+    parallel_options.parse_threads = 4;
+
+    auto with_confuse = Config::parse(config_path, root);
+    auto serial = Config::parse(config_path, root, serial_options);
+    auto parallel = Config::parse(config_path, root, parallel_options);
+    REQUIRE(with_confuse);
+    REQUIRE(serial);
+    REQUIRE(parallel);
+
+    REQUIRE(parallel->find<Option<int>>("repeat")->value() == 4);
+    REQUIRE(parallel->find<Option<List<int>>>("lotto_numbers")->value() == List<int>(4, 8));
+    REQUIRE(parallel->find<Option<List<std::string>>>("settings/tags")->value() == List<std::string>("a", "b"));
+    REQUIRE(parallel->find<Option<int>>("person/p10/age")->value() == 1510);
+    REQUIRE(parallel->find<Option<List<int>>>("person/p10/numbers")->value() == List<int>(0, 1510));
+    REQUIRE(parallel->find<Option<std::string>>("person/p10/firstname")->value() == "name {1510}");
+
+    const auto& parallel_sections = parallel->find<Multisection>("person")->sections();
+    const auto& serial_sections = serial->find<Multisection>("person")->sections();
+    const auto& confuse_sections = with_confuse->find<Multisection>("person")->sections();
+    REQUIRE(parallel_sections.size() == 1500);
+    REQUIRE(serial_sections.size() == 1500);
+    REQUIRE(confuse_sections.size() == 1500);
+
+    bool identical = true;
+    for (size_t i = 0; i < parallel_sections.size(); ++i) {
+        for (const auto* sections : {&serial_sections, &confuse_sections}) {
+            const auto& expected = (*sections)[i];
+            identical = identical && parallel_sections[i].title() == expected.title() &&
+                        parallel_sections[i].find<Option<std::string>>("firstname")->value() ==
+                            expected.find<Option<std::string>>("firstname")->value() &&
+                        parallel_sections[i].find<Option<int>>("age")->value() ==
+                            expected.find<Option<int>>("age")->value() &&
+                        parallel_sections[i].find<Option<List<int>>>("numbers")->value() ==
+                            expected.find<Option<List<int>>>("numbers")->value() &&
+                        parallel_sections[i].find<Option<std::string>>("address/city")->value() ==
+                            expected.find<Option<std::string>>("address/city")->value();
+        }
+    }
+    REQUIRE(identical);
+    REQUIRE(parallel->find<Multisection>("person")->find_range<int>("age", 1990, 2000).size() == 10);
+
+    // A syntax error in a block, which is only parsed by a worker, still fails the parse
+    REQUIRE(!Config::parse_buffer(content + "person broken { age = 1 age }\n", root, parallel_options));
+    REQUIRE(!Config::parse_buffer(content + "person unterminated { age = 1\n", root, parallel_options));
+}
+
+TEST_CASE("Streaming parse") {
+    using namespace confusepp;
+
+    ConfigFormat root{Option<int>("repeat"),
+                      Multisection("person").values(Option<std::string>("firstname"), Option<int>("age"),
+                                                    Option<float>("constant").default_value(1.5f),
+                                                    Option<List<int>>("numbers").default_value(7))};
+
+    std::string content = "repeat = 3\n";
+    for (int i = 0; i < 2000; ++i) {
+        content += "person p" + std::to_string(i) + " {\n    firstname = \"name" + std::to_string(i) +
+                   "\"\n    age = " + std::to_string(i) +
+                   (i % 2 ? "\n    constant = 2.5\n    numbers += {1}\n" : "\n") + "}\n";
+    }
+    content += "repeat = 4\n";
+
+    TemporaryDirectory directory;
+    path config_path = directory.write("streamed.conf", content);
+
+    // Without a mapping the file is read in chunks, which end in the middle of sections
+    for (bool memory_map : {true, false}) {
+        ParseOptions options;
+        options.memory_map = memory_map;
+        size_t number_of_sections = 0;
+        long sum_of_ages = 0;
+        bool defaults_restored = true;
+
+        auto config = Config::stream(
+            config_path, root, "person",
+            [&](const Section& person) {
+                bool odd = number_of_sections % 2;
+                defaults_restored = defaults_restored && person.title() == "p" + std::to_string(number_of_sections) &&
+                                    person.find<Option<float>>("constant")->value() == (odd ? 2.5f : 1.5f) &&
+                                    person.find<Option<List<int>>>("numbers")->value().size() == (odd ? 2U : 1U);
+                sum_of_ages += person.find<Option<int>>("age")->value();
+                ++number_of_sections;
+            },
+            options);
+
+        REQUIRE(config);
+        REQUIRE(number_of_sections == 2000);
+        REQUIRE(sum_of_ages == 1999 * 2000 / 2);
+        REQUIRE(defaults_restored);
+        REQUIRE(config->find<Option<int>>("repeat")->value() == 4);
+        REQUIRE(config->find<Multisection>("person")->sections().empty());
+        REQUIRE(!config->reload());
+    }
+
+    auto ignore = [](const Section&) {};
+    REQUIRE(!Config::stream(config_path, root, "repeat", ignore));
+    REQUIRE(!Config::stream(config_path, root, "unknown", ignore));
+    REQUIRE(!Config::stream("tests/does_not_exist.conf", root, "person", ignore));
+
+    // A stream is parsed serially and loads every value
+    ParseOptions unsupported;
+    unsupported.parse_threads = 2;
+    REQUIRE(!Config::stream(config_path, root, "person", ignore, unsupported));
+    unsupported = {};
+    unsupported.projection = {"person"};
+    REQUIRE(!Config::stream(config_path, root, "person", ignore, unsupported));
+    unsupported = {};
+    unsupported.lazy_load = true;
+    REQUIRE(!Config::stream(config_path, root, "person", ignore, unsupported));
+
+    std::string unterminated = content + "person broken { age = 1\n";
+    REQUIRE(!Config::stream(directory.write("unterminated.conf", unterminated), root, "person", ignore));
+
+    Section streamed_root(root);
+    size_t visited_before_error = 0;
+    REQUIRE(!NativeParser::stream("person a { age = 1 } person b { age = }", streamed_root, "person",
+                                  [&visited_before_error](const Section&) { ++visited_before_error; }));
+    REQUIRE(visited_before_error == 1);
+}
+
+TEST_CASE("Projection") {
+    using namespace confusepp;
+
+    ConfigFormat root{Option<int>("repeat").default_value(1), Option<List<int>>("lotto_numbers").default_value(42),
+                      Section("settings").values(Option<std::string>("name").default_value("none")),
+                      Multisection("person").values(Option<std::string>("firstname"), Option<int>("age")),
+                      Multisection("city").values(Option<std::string>("state"))};
+
+    std::string content = "repeat = 3\nlotto_numbers = {4, 8, 15}\nsettings { name = \"} not the end {\" }\n"
+                          "person turing { firstname = \"Alan\" age = 41 }\n"
+                          "city hanover { state = \"Lower Saxony\" /* } */ }\n"
+                          "person euler { firstname = \"Leonhard\" # }\n age = 76 }\n";
+
+    ParseOptions native_options;
+    native_options.native_parser = true;
+    native_options.projection = {"/person/turing", "repeat"};
+    ParseOptions confuse_options;
+    confuse_options.projection = native_options.projection;
+
+    for (const auto& options : {native_options, confuse_options}) {
+        auto config = Config::parse_buffer(content, root, options);
+        REQUIRE(config);
+
+        // A prefix inside of a top-level element loads all of it
+        REQUIRE(config->find<Option<int>>("repeat")->value() == 3);
+        REQUIRE(config->find<Multisection>("person")->sections().size() == 2);
+        REQUIRE(config->find<Option<int>>("person/euler/age")->value() == 76);
+
+        REQUIRE(config->find<Option<List<int>>>("lotto_numbers")->value() == List<int>(42));
+        REQUIRE(config->find<Option<std::string>>("settings/name")->value() == "none");
+        REQUIRE(config->find<Multisection>("city")->sections().empty());
+    }
+
+    // Skipped elements are still checked against the tree and for balanced braces
+    REQUIRE(!Config::parse_buffer(content + "unknown = 1\n", root, native_options));
+    REQUIRE(!Config::parse_buffer(content + "city broken { state = \"x\"\n", root, native_options));
+    REQUIRE(!Config::parse_buffer(content + "city \"unterminated { }\n", root, native_options));
+
+    // The content of a skipped element isn't checked against the tree
+    REQUIRE(Config::parse_buffer(content + "city hamburg { unknown = 1 }\n", root, native_options));
+}
+
+TEST_CASE("Lazy loading") {
+    using namespace confusepp;
+
+    ConfigFormat root{Option<std::string>("target"), Option<int>("repeat").default_value(13),
+                      Option<List<int>>("lotto_numbers").default_value(42), Option<List<float>>("irrational_numbers"),
+                      Option<List<std::string>>("presidents"), Option<List<bool>>("a_boolean_list"),
+                      Option<std::string>("lastname"),
+                      Multisection("person")
+                          .values(Option<std::string>("firstname"), Option<std::string>("lastname"),
+                                  Option<bool>("male"), Option<int>("age"), Option<float>("constant"))
+                          .index_on("age"),
+                      Section("capital_of_states_in_germany")
+                          .values(Option<std::string>("Baden-Württemberg"), Option<std::string>("Bavaria"),
+                                  Option<std::string>("Berlin"), Option<std::string>("Brandenburg"),
+                                  Option<std::string>("Bremen"), Option<std::string>("Hamburg"),
+                                  Option<std::string>("Hesse"), Option<std::string>("Lower Saxony"),
+                                  Option<std::string>("Mecklenburg-Vorpommern"),
+                                  Option<std::string>("North Rhine-Westphalia"),
+                                  Option<std::string>("Rhineland-Palatinate"), Option<std::string>("Saarland"),
+                                  Option<std::string>("Saxony"), Option<std::string>("Saxony-Anhalt"),
+                                  Option<std::string>("Schleswig-Holstein"), Option<std::string>("Thuringia"))};
+
+    ParseOptions lazy;
+    lazy.lazy_load = true;
+
+    auto eager_config = Config::parse("tests/tests.conf", root);
+    auto lazy_config = Config::parse("tests/tests.conf", root, lazy);
+    REQUIRE(eager_config);
+    REQUIRE(lazy_config);
+
+    REQUIRE(lazy_config->find<Option<std::string>>("target")->value() == "Neighbour");
+    REQUIRE(lazy_config->find<Option<List<int>>>("lotto_numbers")->value() ==
+            eager_config->find<Option<List<int>>>("lotto_numbers")->value());
+    REQUIRE(lazy_config->find<Option<List<std::string>>>("presidents")->value() ==
+            eager_config->find<Option<List<std::string>>>("presidents")->value());
+    REQUIRE(lazy_config->find<Option<float>>("person/euler/constant")->value() ==
+            eager_config->find<Option<float>>("person/euler/constant")->value());
+
+    // The index is built while loading, so it converts the field it is built on
+    REQUIRE(lazy_config->find<Multisection>("person")->find_range<int>("age", 40, 50).size() == 1);
+
+    // A copy converts the value first, so it doesn't refer to the handle of the Config
+    auto copied = lazy_config->get<Option<std::string>>("capital_of_states_in_germany/Bavaria");
+    REQUIRE(copied->value() == "Munich");
+    auto copied_section = lazy_config->find<Multisection>("person")->operator[]("turing");
+    REQUIRE(copied_section->find<Option<std::string>>("firstname")->value() == "Alan");
+
+    // Every thread converts the same values for the first time at once
+    const char* states[] = {"Hamburg", "Hesse", "Lower Saxony", "Saxony", "Thuringia", "Bremen", "Berlin"};
+    std::atomic<size_t> number_of_matches = 0;
+    std::vector<std::thread> threads;
+
+    for (int thread_index = 0; thread_index < 8; ++thread_index) {
+        threads.emplace_back([&] {
+            for (const char* state : states) {
+                std::string state_path = std::string("capital_of_states_in_germany/") + state;
+                number_of_matches += lazy_config->find<Option<std::string>>(state_path)->value() ==
+                                     eager_config->find<Option<std::string>>(state_path)->value();
+            }
+            number_of_matches += lazy_config->find<Option<List<bool>>>("a_boolean_list")->value().size() == 5;
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(number_of_matches == 8 * (std::size(states) + 1));
+
+    REQUIRE(lazy_config->reload());
+    REQUIRE(lazy_config->find<Option<int>>("person/turing/age")->value() == 41);
+    REQUIRE(lazy_config->find<Option<int>>("repeat")->value() == 3);
+
+    // The mutex which guards the conversions belongs to the Config and moves with it
+    Config moved(std::move(*Config::parse("tests/tests.conf", root, lazy)));
+    REQUIRE(moved.find<Option<std::string>>("capital_of_states_in_germany/Saxony")->value() == "Dresden");
 }